@@ -4,20 +4,83 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../src/schedalgos.c 
+../src/arena.c \
+../src/checkpoint.c \
+../src/engine.c \
+../src/heap.c \
+../src/output.c \
+../src/prioqueue.c \
+../src/proctable.c \
+../src/profile.c \
+../src/rbtree.c \
+../src/replay.c \
+../src/sched.c \
+../src/schedalgos.c \
+../src/smp.c \
+../src/sort.c \
+../src/stats.c \
+../src/stream.c \
+../src/sweep.c \
+../src/synth.c \
+../src/threadpool.c \
+../src/timeline.c \
+../src/timerwheel.c \
+../src/workload.c 
 
 OBJS += \
-./src/schedalgos.o 
+./src/arena.o \
+./src/checkpoint.o \
+./src/engine.o \
+./src/heap.o \
+./src/output.o \
+./src/prioqueue.o \
+./src/proctable.o \
+./src/profile.o \
+./src/rbtree.o \
+./src/replay.o \
+./src/sched.o \
+./src/schedalgos.o \
+./src/smp.o \
+./src/sort.o \
+./src/stats.o \
+./src/stream.o \
+./src/sweep.o \
+./src/synth.o \
+./src/threadpool.o \
+./src/timeline.o \
+./src/timerwheel.o \
+./src/workload.o 
 
 C_DEPS += \
-./src/schedalgos.d 
+./src/arena.d \
+./src/checkpoint.d \
+./src/engine.d \
+./src/heap.d \
+./src/output.d \
+./src/prioqueue.d \
+./src/proctable.d \
+./src/profile.d \
+./src/rbtree.d \
+./src/replay.d \
+./src/sched.d \
+./src/schedalgos.d \
+./src/smp.d \
+./src/sort.d \
+./src/stats.d \
+./src/stream.d \
+./src/sweep.d \
+./src/synth.d \
+./src/threadpool.d \
+./src/timeline.d \
+./src/timerwheel.d \
+./src/workload.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 src/%.o: ../src/%.c
 	@echo 'Building file: $<'
 	@echo 'Invoking: GCC C Compiler'
-	gcc -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o"$@" "$<"
+	gcc -O0 -g3 -Wall -c -fmessage-length=0 -pthread -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o"$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
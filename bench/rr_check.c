@@ -0,0 +1,132 @@
+/*
+ ============================================================================
+ Name        : rr_check.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Checks Round Robin of simulate() against the tick loop of the
+               old roundrobin(), which walked the table in arrival order a
+               quantum at a time. Random workloads with staggered arrivals
+               are run through both; startTime, finishTime and waitingTime
+               must agree. The old loop idled a whole quantum on a process
+               not yet arrived even with others ready, and could stop
+               before every process finished; workloads where it did so
+               are skipped, it never handled them.
+ Usage       : rr_check [workloads]
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "engine.h"
+#include "arena.h"
+
+#define MAX_PROCESSES 12
+
+/* Staggered workload from the review of the event engine, with what the tick loop gave for quantum 1 */
+static const simTime fixedArrival[] = {0, 0, 0, 2, 3, 3};
+static const simTime fixedBurst[] = {5, 5, 4, 4, 2, 6};
+static const simTime fixedStart[] = {0, 1, 2, 3, 4, 5};
+static const simTime fixedFinish[] = {23, 24, 20, 21, 11, 26};
+
+/*
+ * roundrobin() of the tick based version on a table sorted by arrival, one tick per step.
+ * Returns 0 if it ran every process to the end without idling a tick while one had arrived, -1 otherwise.
+ */
+static int tickRoundRobin(int n, const simTime arrival[], const simTime burst[], simTime quantum, simTime start[],
+		simTime finish[]) {
+	simTime left[MAX_PROCESSES], totalServiceTime = 0, currentTime = 0, j;
+	int i, idled = 0;
+
+	for(i=0; i<n; i++) {
+		left[i] = burst[i];
+		start[i] = -1;
+		finish[i] = -1;
+		totalServiceTime += burst[i];
+	}
+	for(i=0; currentTime <= totalServiceTime - 1; i++) {
+		if(i == n) {
+			i = 0;
+		}
+		for(j=0; j<quantum; j++) {
+			if(arrival[i] <= currentTime) {
+				if(left[i] == 0) {
+					continue;
+				}
+				left[i]--;
+				if(start[i] == -1) {
+					start[i] = currentTime;
+				}
+				currentTime++;
+				if(left[i] == 0) {
+					finish[i] = currentTime;
+				}
+			} else {
+				currentTime++;
+				idled = 1;
+			}
+		}
+	}
+	for(i=0; i<n; i++) {
+		if(finish[i] == -1) {
+			idled = 1;
+		}
+	}
+	return idled ? -1 : 0;
+}
+
+/* Runs simulate() on the workload and counts processes disagreeing with the given start and finish times */
+static int compare(int n, const simTime arrival[], const simTime burst[], simTime quantum, const simTime start[],
+		const simTime finish[]) {
+	procTable t;
+	arena mem;
+	int i, mismatch = 0;
+
+	if(arenaInit(&mem, n * PROC_TABLE_BYTES) != 0 || procTableInit(&t, &mem, n) != 0) {
+		fprintf(stderr, "Out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	t.strings = "P";
+	t.stringsSize = 2;
+	for(i=0; i<n; i++) {
+		t.arrivalTime[i] = arrival[i];
+		t.burstTime[i] = burst[i];
+	}
+	if(simulate(&t, ALGO_RR, quantum, NULL, NULL) < 0) {
+		fprintf(stderr, "Out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	for(i=0; i<n; i++) {
+		if(t.startTime[i] != start[i] || t.finishTime[i] != finish[i] || t.waitingTime[i] != start[i] - arrival[i]) {
+			fprintf(stderr, "Process %d of %d, quantum %lld: tick loop %lld..%lld, engine %lld..%lld\n", i, n, quantum,
+					start[i], finish[i], t.startTime[i], t.finishTime[i]);
+			mismatch++;
+		}
+	}
+	arenaFree(&mem);
+	return mismatch;
+}
+
+int main(int argc, char *argv[]) {
+	int workloads = argc > 1 ? atoi(argv[1]) : 100000;
+	int w, i, n, checked = 0, failed = 0;
+	simTime arrival[MAX_PROCESSES], burst[MAX_PROCESSES], start[MAX_PROCESSES], finish[MAX_PROCESSES], quantum;
+
+	failed += compare(6, fixedArrival, fixedBurst, 1, fixedStart, fixedFinish) > 0;
+
+	srand(7);
+	for(w=0; w<workloads; w++) {
+		n = 1 + rand() % MAX_PROCESSES;
+		quantum = 1 + rand() % 4;
+		for(i=0; i<n; i++) {
+			arrival[i] = i == 0 ? 0 : arrival[i - 1] + rand() % 3;
+			burst[i] = 1 + rand() % 8;
+		}
+		if(tickRoundRobin(n, arrival, burst, quantum, start, finish) != 0) {
+			continue;
+		}
+		checked++;
+		failed += compare(n, arrival, burst, quantum, start, finish) > 0;
+	}
+	printf("%d workloads checked, %d skipped, %d differ\n", checked, workloads - checked, failed);
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*
+ ============================================================================
+ Name        : sched_bench.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Times every algorithm through sched_run() on the synthetic
+               workloads of synth.h, from 10 jobs up by powers of ten.
+               Each case runs in a child process of its own so that its
+               peak resident memory is reported alone. Prints CSV:
+               workload,jobs,algo,decisions,seconds,ns_per_decision,peak_rss_kb
+               where a decision is one dispatch of a process onto the CPU
+               and seconds excludes generating the workload.
+ Usage       : sched_bench [maxJobs [quantum]]
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "sched.h"
+#include "synth.h"
+
+static const char *const algoName[] = { "", "fcfs", "sjfp", "priority", "rr", "ppriority", "mlfq", "cfs" };
+
+#define AGING_INTERVAL 50		/* Preemptive Priority */
+#define BOOST_INTERVAL 1000		/* MLFQ, with quanta of 1, 2 and 4 times the quantum */
+#define SCHED_LATENCY 24			/* CFS, defaults of schedalgos */
+#define MIN_GRANULARITY 3
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void countDecision(const procTable *t, int running, simTime start, simTime length, void *arg) {
+	if(running != IDLE_PROCESS) {
+		(*(long long *)arg)++;
+	}
+}
+
+/* Body of the child process of one case, returns exit status */
+static int runCase(int kind, int jobs, int algo, simTime quantum) {
+	long long decisions = 0;
+	schedParams params = { quantum, 0, countDecision, &decisions };
+	schedResult run;
+	struct rusage usage;
+	workload wl;
+	arena mem;
+	double t0;
+
+	params.agingInterval = AGING_INTERVAL;
+	params.mlfq = (mlfqParams){ 3, { quantum, 2 * quantum, 4 * quantum }, BOOST_INTERVAL };
+	params.cfs = (cfsParams){ SCHED_LATENCY, MIN_GRANULARITY };
+	if(synthWorkload(&wl, &mem, kind, jobs, 1) != 0) {
+		fprintf(stderr, "Out of memory generating %d jobs\n", jobs);
+		return EXIT_FAILURE;
+	}
+	t0 = now();
+	if(sched_run(algo, &wl, &params, &run) != 0) {
+		fprintf(stderr, "Out of memory running %d jobs\n", jobs);
+		return EXIT_FAILURE;
+	}
+	t0 = now() - t0;
+	getrusage(RUSAGE_SELF, &usage);
+	printf("%s,%d,%s,%lld,%.6f,%.2f,%ld\n", synthName[kind], jobs, algoName[algo], decisions, t0,
+			decisions ? t0 * 1e9 / decisions : 0, usage.ru_maxrss);
+	sched_result_free(&run);
+	arenaFree(&mem);
+	return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+	int maxJobs = argc > 1 ? atoi(argv[1]) : 10000000;
+	simTime quantum = argc > 2 ? atoll(argv[2]) : 4;
+	int kind, jobs, algo, status, failed = 0;
+	pid_t child;
+
+	printf("workload,jobs,algo,decisions,seconds,ns_per_decision,peak_rss_kb\n");
+	fflush(stdout);
+	for(kind=0; kind<SYNTH_KINDS; kind++) {
+		for(jobs=10; jobs<=maxJobs; jobs*=10) {
+			for(algo=ALGO_FCFS; algo<=ALGO_CFS; algo++) {
+				child = fork();
+				if(child == 0) {
+					status = runCase(kind, jobs, algo, quantum);
+					fflush(stdout);
+					_exit(status);
+				}
+				if(child < 0 || waitpid(child, &status, 0) < 0 || !WIFEXITED(status) ||
+						WEXITSTATUS(status) != EXIT_SUCCESS) {
+					failed = 1;
+				}
+			}
+		}
+	}
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*
+ ============================================================================
+ Name        : sjfp_bench.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Compares ready queue of Shortest Job First (Preemptive).
+               "scan" picks next process the way old selectProcess() did,
+               scanning every arrived process for smallest non-zero burst.
+               "heap" is simulate() with its indexed min-heap.
+               Both are driven by the same events so only selection differs.
+ Usage       : sjfp_bench [maxProcesses [maxScanProcesses]]
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "engine.h"
+#include "arena.h"
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Random workload already sorted by arrival, mean inter-arrival 2 ticks, bursts 1..20 */
+static int makeWorkload(procTable *pproc, arena *mem, int n, unsigned seed) {
+	int i;
+	simTime t = 0;
+
+	if(arenaInit(mem, n * PROC_TABLE_BYTES) != 0 || procTableInit(pproc, mem, n) != 0) {
+		return -1;
+	}
+	pproc->strings = "P";
+	pproc->stringsSize = 2;
+	srand(seed);
+	for(i=0; i<n; i++) {
+		t += rand() % 5;
+		pproc->arrivalTime[i] = t;
+		pproc->burstTime[i] = 1 + rand() % 20;
+	}
+	return 0;
+}
+
+/* selectProcess() of the tick based version: linear scan of arrived prefix */
+static int scanSelect(const simTime burst[], int arrived) {
+	int j, best = -1;
+
+	for(j=0; j<arrived; j++) {
+		if(burst[j] != 0 && (best == -1 || burst[j] < burst[best])) {
+			best = j;
+		}
+	}
+	return best;
+}
+
+/* Event driven SJF using scanSelect, counts scheduling decisions */
+static int scanSimulate(procTable *pproc, long *decisions) {
+	simTime currentTime = 0, slice;
+	int n = pproc->numOfProcesses, arrived = 0, done = 0, running;
+
+	while(done < n) {
+		while(arrived < n && pproc->arrivalTime[arrived] <= currentTime) {
+			arrived++;
+		}
+		running = scanSelect(pproc->burstTime, arrived);
+		if(running == -1) {
+			currentTime = pproc->arrivalTime[arrived];
+			continue;
+		}
+		(*decisions)++;
+		slice = pproc->burstTime[running];
+		if(arrived < n && pproc->arrivalTime[arrived] < currentTime + slice) {
+			slice = pproc->arrivalTime[arrived] - currentTime;
+		}
+		currentTime += slice;
+		pproc->burstTime[running] -= slice;
+		if(pproc->burstTime[running] == 0) {
+			pproc->finishTime[running] = currentTime;
+			done++;
+		}
+	}
+	return currentTime;
+}
+
+static void countRun(const procTable *pproc, int running, simTime start, simTime length, void *arg) {
+	if(running != IDLE_PROCESS) (*(long *)arg)++;
+}
+
+int main(int argc, char *argv[]) {
+	int maxProcesses = argc > 1 ? atoi(argv[1]) : 1000000;
+	int maxScan = argc > 2 ? atoi(argv[2]) : 50000;
+	int n, i, mismatch;
+	procTable a, b;
+	arena memA, memB;
+	long decisions;
+	double t0, scanTime, heapTime;
+
+	printf("processes,algorithm,decisions,seconds,ns_per_decision\n");
+	for(n=1000; n<=maxProcesses; n*=10) {
+		if(makeWorkload(&a, &memA, n, 42) != 0 || makeWorkload(&b, &memB, n, 42) != 0) {
+			fprintf(stderr, "Out of memory at %d processes\n", n);
+			return EXIT_FAILURE;
+		}
+
+		if(n <= maxScan) {
+			decisions = 0;
+			t0 = now();
+			scanSimulate(&a, &decisions);
+			scanTime = now() - t0;
+			printf("%d,scan,%ld,%.6f,%.1f\n", n, decisions, scanTime, scanTime * 1e9 / decisions);
+		}
+
+		decisions = 0;
+		t0 = now();
+		simulate(&b, ALGO_SJFP, 0, countRun, &decisions);
+		heapTime = now() - t0;
+		printf("%d,heap,%ld,%.6f,%.1f\n", n, decisions, heapTime, heapTime * 1e9 / decisions);
+
+		if(n <= maxScan) {
+			for(i=0, mismatch=0; i<n; i++) {
+				mismatch += a.finishTime[i] != b.finishTime[i];
+			}
+			if(mismatch) {
+				fprintf(stderr, "scan and heap disagree on %d finish times\n", mismatch);
+				return EXIT_FAILURE;
+			}
+		}
+		arenaFree(&memA);
+		arenaFree(&memB);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/*
+ ============================================================================
+ Name        : sort_bench.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Compares orderings of the process table by arrivalTime.
+               "bubble" is the old psort() on an array of records, "merge"
+               and "radix" sort the index array only, "table" is
+               sortProcesses() i.e. radix sort plus gathering every column.
+ Usage       : sort_bench [maxProcesses [maxBubbleProcesses]]
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "engine.h"
+#include "arena.h"
+#include "sort.h"
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Process record of the array of structures table psort() used to sort */
+typedef struct {
+	const char *name;
+	simTime arrivalTime, burstTime, startTime, finishTime, waitingTime, IsActiveFor;
+	int priority;
+}record;
+
+/* psort() before it was replaced */
+static void bubbleSort(record pproc[], int n) {
+	int i, j, test;
+	record temp;
+
+	for(i = n - 1; i > 0; i--) {
+		test = 0;
+		for(j=0; j < i; j++) {
+			if((pproc[j].arrivalTime) > (pproc[j+1].arrivalTime) ) {
+				temp = pproc[j];
+				pproc[j] = pproc[j+1];
+				pproc[j+1] = temp;
+				test=1;
+			}
+		}
+		if(test==0) break;
+	}
+}
+
+/* Sorted by arrival, ties in original order (priority field holds original position) */
+static int checkTable(const procTable *pproc) {
+	int i;
+
+	for(i=1; i<pproc->numOfProcesses; i++) {
+		if(pproc->arrivalTime[i-1] > pproc->arrivalTime[i] ||
+				(pproc->arrivalTime[i-1] == pproc->arrivalTime[i] && pproc->priority[i-1] > pproc->priority[i])) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static void makeKeys(const procTable *pproc, unsigned long long key[], int order[], int n) {
+	int i;
+
+	for(i=0; i<n; i++) {
+		key[i] = pproc->arrivalTime[i];
+		order[i] = i;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	int maxProcesses = argc > 1 ? atoi(argv[1]) : 10000000;
+	int maxBubble = argc > 2 ? atoi(argv[2]) : 20000;
+	int n, i;
+	procTable base, table;
+	arena mem;
+	record *bubble;
+	unsigned long long *key;
+	int *order;
+	double t0;
+
+	printf("processes,algorithm,seconds,ns_per_process\n");
+	for(n=10000; n<=maxProcesses; n*=10) {
+		key = malloc(n * sizeof(*key));
+		order = malloc(n * sizeof(*order));
+		if(arenaInit(&mem, 2 * n * PROC_TABLE_BYTES) != 0 || procTableInit(&base, &mem, n) != 0 ||
+				procTableInit(&table, &mem, n) != 0 || key == NULL || order == NULL) {
+			fprintf(stderr, "Out of memory at %d processes\n", n);
+			return EXIT_FAILURE;
+		}
+		srand(7);
+		for(i=0; i<n; i++) {
+			base.arrivalTime[i] = rand() % (n / 2 + 1);	/*Plenty of equal arrivals to check stability*/
+			base.burstTime[i] = 1 + rand() % 20;
+			base.priority[i] = i;
+		}
+		base.strings = table.strings = "P";
+
+		if(n <= maxBubble && (bubble = calloc(n, sizeof(record))) != NULL) {
+			for(i=0; i<n; i++) {
+				bubble[i].name = "P";
+				bubble[i].arrivalTime = base.arrivalTime[i];
+				bubble[i].burstTime = base.burstTime[i];
+				bubble[i].priority = base.priority[i];
+			}
+			t0 = now();
+			bubbleSort(bubble, n);
+			t0 = now() - t0;
+			printf("%d,bubble,%.6f,%.1f\n", n, t0, t0 * 1e9 / n);
+			free(bubble);
+		}
+
+		makeKeys(&base, key, order, n);
+		t0 = now();
+		mergeSortIndex(key, order, n);
+		t0 = now() - t0;
+		printf("%d,merge,%.6f,%.1f\n", n, t0, t0 * 1e9 / n);
+
+		makeKeys(&base, key, order, n);
+		t0 = now();
+		radixSortIndex(key, order, n);
+		t0 = now() - t0;
+		printf("%d,radix,%.6f,%.1f\n", n, t0, t0 * 1e9 / n);
+
+		memcpy(table.arrivalTime, base.arrivalTime, n * sizeof(simTime));
+		memcpy(table.burstTime, base.burstTime, n * sizeof(simTime));
+		memcpy(table.priority, base.priority, n * sizeof(int));
+		t0 = now();
+		sortProcesses(&table, SORT_BY_ARRIVAL);
+		t0 = now() - t0;
+		printf("%d,table,%.6f,%.1f\n", n, t0, t0 * 1e9 / n);
+		if(!checkTable(&table)) {
+			fprintf(stderr, "sortProcesses is not a stable sort\n");
+			return EXIT_FAILURE;
+		}
+
+		arenaFree(&mem);
+		free(key);
+		free(order);
+	}
+	return EXIT_SUCCESS;
+}
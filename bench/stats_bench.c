@@ -0,0 +1,76 @@
+/*
+ ============================================================================
+ Name        : stats_bench.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Times computeStats() over finished runs of growing size with
+               the scalar kernel and with the widest SIMD kernel of the CPU,
+               and checks both give the same statistics.
+ Usage       : stats_bench [maxProcesses]
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "stats.h"
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Finished FCFS-like run: processes back to back, some waiting */
+static int makeRun(procTable *pproc, arena *mem, int n) {
+	int i;
+	simTime t = 0, burst;
+
+	if(arenaInit(mem, n * PROC_TABLE_BYTES) != 0 || procTableInit(pproc, mem, n) != 0) {
+		return -1;
+	}
+	srand(3);
+	for(i=0; i<n; i++) {
+		burst = 1 + rand() % 20;
+		pproc->arrivalTime[i] = i * 9 / 10;
+		pproc->startTime[i] = t > pproc->arrivalTime[i] ? t : pproc->arrivalTime[i];
+		t = pproc->startTime[i] + burst;
+		pproc->finishTime[i] = t;
+		pproc->IsActiveFor[i] = burst;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	int maxProcesses = argc > 1 ? atoi(argv[1]) : 10000000;
+	int n, scalar;
+	procTable table;
+	arena mem;
+	runStats st[2];
+	double t0;
+
+	printf("processes,kernel,seconds,ns_per_process\n");
+	for(n=10000; n<=maxProcesses; n*=10) {
+		if(makeRun(&table, &mem, n) != 0) {
+			fprintf(stderr, "Out of memory at %d processes\n", n);
+			return EXIT_FAILURE;
+		}
+		for(scalar=1; scalar>=0; scalar--) {
+			statsForceScalar(scalar);
+			t0 = now();
+			if(computeStats(&table, table.finishTime[n-1], 0, &st[scalar]) != 0) {
+				fprintf(stderr, "Out of memory at %d processes\n", n);
+				return EXIT_FAILURE;
+			}
+			t0 = now() - t0;
+			printf("%d,%s,%.6f,%.2f\n", n, scalar ? "scalar" : "simd", t0, t0 * 1e9 / n);
+		}
+		if(memcmp(&st[0], &st[1], sizeof(runStats)) != 0) {
+			fprintf(stderr, "scalar and simd statistics differ\n");
+			return EXIT_FAILURE;
+		}
+		arenaFree(&mem);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+/*
+ ============================================================================
+ Name        : arena.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Bump allocator, see arena.h
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "profile.h"
+
+#define ARENA_ALIGN 16
+#define ALIGN_UP(n) (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+#define BLOCK_HEADER ALIGN_UP(sizeof(arenaBlock))
+
+static arenaBlock *newBlock(size_t size, arenaBlock *prev) {
+	arenaBlock *block = malloc(BLOCK_HEADER + size);
+
+	if(block == NULL) {
+		return NULL;
+	}
+	block->prev = prev;
+	block->size = size;
+	block->used = 0;
+	PROF_COUNT(PROF_BLOCKS, 1);
+	return block;
+}
+
+/**
+ * Function Name: 	arenaInit
+ * Function:		Creates arena with one block of given size
+ * Input:			Arena, expected number of bytes needed by the run
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Arena
+ */
+
+int arenaInit(arena *a, size_t size) {
+	a->current = newBlock(ALIGN_UP(size > 0 ? size : ARENA_ALIGN), NULL);
+	return a->current ? 0 : -1;
+}
+
+/**
+ * Function Name: 	arenaAlloc
+ * Function:		Hands out zeroed memory from current block. When block is full a new one
+ * 					at least twice as big is chained so that repeated growth stays amortised
+ * Input:			Arena, number of bytes
+ * Output:			Pointer to memory aligned to 16 bytes, NULL if out of memory
+ * Affects:			Arena
+ */
+
+void *arenaAlloc(arena *a, size_t size) {
+	arenaBlock *block = a->current;
+	size_t grow;
+	void *mem;
+
+	size = ALIGN_UP(size);
+	if(block == NULL || block->size - block->used < size) {
+		grow = block ? block->size * 2 : ARENA_ALIGN;
+		block = newBlock(size > grow ? size : grow, block);
+		if(block == NULL) {
+			return NULL;
+		}
+		a->current = block;
+	}
+	mem = (char *)block + BLOCK_HEADER + block->used;
+	block->used += size;
+	memset(mem, 0, size);
+	PROF_COUNT(PROF_ALLOCS, 1);
+	PROF_COUNT(PROF_ALLOC_BYTES, size);
+	return mem;
+}
+
+void arenaFree(arena *a) {
+	arenaBlock *block = a->current, *prev;
+
+	while(block) {
+		prev = block->prev;
+		free(block);
+		block = prev;
+	}
+	a->current = NULL;
+}
@@ -0,0 +1,32 @@
+/*
+ ============================================================================
+ Name        : arena.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Bump allocator for storage that lives as long as one
+               simulation run. Memory comes from one block sized from the
+               input; a new block is chained only if the guess was too small.
+               Everything is released at once by arenaFree.
+ ============================================================================
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stddef.h>
+
+typedef struct arenaBlock {
+	struct arenaBlock *prev;	/* Previously filled block, NULL for first one */
+	size_t size;				/* Usable bytes following the header */
+	size_t used;
+}arenaBlock;
+
+typedef struct {
+	arenaBlock *current;
+}arena;
+
+int arenaInit(arena *, size_t);			/* Allocates first block, returns 0 on success */
+void *arenaAlloc(arena *, size_t);		/* Returns zeroed memory, NULL if out of memory */
+void arenaFree(arena *);				/* Releases every block */
+
+#endif /* ARENA_H_ */
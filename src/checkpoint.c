@@ -0,0 +1,114 @@
+/*
+ ============================================================================
+ Name        : checkpoint.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Checkpoint log of the discrete event engine, see checkpoint.h.
+               Checkpoints and their queues are kept in two arrays that
+               double when full.
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include "checkpoint.h"
+
+int checkpointInit(checkpointLog *log, simTime interval) {
+	log->interval = interval;
+	log->cp = NULL;
+	log->entry = NULL;
+	log->numCheckpoints = log->capacity = 0;
+	log->numEntries = log->entryCapacity = 0;
+	return interval > 0 ? 0 : -1;
+}
+
+void checkpointFree(checkpointLog *log) {
+	free(log->cp);
+	free(log->entry);
+	log->cp = NULL;
+	log->entry = NULL;
+	log->numCheckpoints = log->capacity = 0;
+	log->numEntries = log->entryCapacity = 0;
+}
+
+/**
+ * Function Name: 	checkpointBegin
+ * Function:		Starts a checkpoint, its queue follows with checkpointAdd()
+ * Input:			Log, simulated time, next process to arrive, finished processes, last process run, counters so far
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Log
+ */
+
+int checkpointBegin(checkpointLog *log, simTime time, int nextArrival, int done, int lastRun, const engineCounters *counters) {
+	checkpoint *grown, *cp;
+
+	if(log->numCheckpoints == log->capacity) {
+		grown = realloc(log->cp, (log->capacity > 0 ? 2 * log->capacity : 16) * sizeof(checkpoint));
+		if(grown == NULL) {
+			return -1;
+		}
+		log->cp = grown;
+		log->capacity = log->capacity > 0 ? 2 * log->capacity : 16;
+	}
+	cp = &log->cp[log->numCheckpoints++];
+	cp->time = time;
+	cp->nextArrival = nextArrival;
+	cp->done = done;
+	cp->lastRun = lastRun;
+	cp->counters = *counters;
+	cp->first = log->numEntries;
+	cp->count = 0;
+	return 0;
+}
+
+int checkpointAdd(checkpointLog *log, int index, simTime remaining, simTime startTime, simTime ran) {
+	checkpointEntry *grown, *e;
+
+	if(log->numEntries == log->entryCapacity) {
+		grown = realloc(log->entry, (log->entryCapacity > 0 ? 2 * log->entryCapacity : 256) * sizeof(checkpointEntry));
+		if(grown == NULL) {
+			return -1;
+		}
+		log->entry = grown;
+		log->entryCapacity = log->entryCapacity > 0 ? 2 * log->entryCapacity : 256;
+	}
+	e = &log->entry[log->numEntries++];
+	e->index = index;
+	e->remaining = remaining;
+	e->startTime = startTime;
+	e->ran = ran;
+	log->cp[log->numCheckpoints - 1].count++;
+	return 0;
+}
+
+/**
+ * Function Name: 	checkpointFind
+ * Function:		Finds the last checkpoint from which a workload changed at given process can resume: every
+ * 					process that checkpoint depends on comes before the change. Binary search, checkpoints are in
+ * 					order of time and so of next arrival
+ * Input:			Log, index of first changed process in arrival order
+ * Output:			Checkpoint number, -1 if none
+ * Affects:			Nothing
+ * NOTES:			Engine may have looked at arrival time of the next process before the checkpoint (to jump an
+ * 					idle gap or cut a slice), so it must come before the change too.
+ */
+
+int checkpointFind(const checkpointLog *log, int firstChanged) {
+	int lo = 0, hi = log->numCheckpoints, mid;
+
+	while(lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if(log->cp[mid].nextArrival < firstChanged) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo - 1;
+}
+
+void checkpointTruncate(checkpointLog *log, int keep) {
+	if(keep < log->numCheckpoints) {
+		log->numCheckpoints = keep > 0 ? keep : 0;
+		log->numEntries = keep > 0 ? log->cp[keep - 1].first + log->cp[keep - 1].count : 0;
+	}
+}
@@ -0,0 +1,59 @@
+/*
+ ============================================================================
+ Name        : checkpoint.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Snapshots of the discrete event engine taken every so many
+               ticks of simulated time, so that a run of a slightly changed
+               workload can resume from the last snapshot taken before the
+               first change instead of from time 0. A snapshot holds the
+               clock, the next arrival and every queued process with its
+               remaining burst; finished processes and those not yet
+               arrived need nothing, so its size is that of the ready queue.
+ ============================================================================
+ */
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include <stddef.h>
+#include "proctable.h"
+#include "counters.h"
+
+/* A queued process, in queue order */
+typedef struct {
+	int index;
+	simTime remaining;
+	simTime startTime;
+	simTime ran;				/* IsActiveFor so far */
+}checkpointEntry;
+
+typedef struct {
+	simTime time;
+	int nextArrival;			/* Processes before it have arrived, those after it are untouched */
+	int done;
+	int lastRun;				/* Last process that ran, for counting context switches */
+	engineCounters counters;	/* Counts so far */
+	size_t first;				/* First entry of its queue */
+	int count;
+}checkpoint;
+
+typedef struct {
+	simTime interval;			/* Ticks between checkpoints */
+	checkpoint *cp;
+	int numCheckpoints;
+	int capacity;
+	checkpointEntry *entry;		/* Queues of all checkpoints one after another */
+	size_t numEntries;
+	size_t entryCapacity;
+}checkpointLog;
+
+int checkpointInit(checkpointLog *, simTime);	/* Empty log taking one checkpoint per given ticks, 0 on success */
+void checkpointFree(checkpointLog *);
+int checkpointBegin(checkpointLog *, simTime, int, int, int, const engineCounters *);	/* Time, next arrival, done, last run, counters.
+																		   0 on success, -1 if out of memory */
+int checkpointAdd(checkpointLog *, int, simTime, simTime, simTime);	/* Queued process, remaining, start, ran. Same */
+int checkpointFind(const checkpointLog *, int);	/* Last checkpoint not having admitted given process, -1 if none */
+void checkpointTruncate(checkpointLog *, int);	/* Keeps given number of checkpoints */
+
+#endif /* CHECKPOINT_H_ */
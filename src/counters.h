@@ -0,0 +1,33 @@
+/*
+ ============================================================================
+ Name        : counters.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Counters every discrete event engine keeps of its run. They
+               are updated with a few additions per scheduling event, never
+               per tick, and are part of engine checkpoints so a resumed
+               run ends with the same counts as a fresh one.
+               A context switch is a CPU going from one process to another
+               (idle time in between does not matter). A preemption is a
+               switch away from a process that had not finished.
+ ============================================================================
+ */
+
+#ifndef COUNTERS_H_
+#define COUNTERS_H_
+
+#include "proctable.h"
+
+typedef struct {
+	long long switches;			/* Context switches */
+	long long preemptions;		/* Context switches away from an unfinished process */
+	simTime idleTime;			/* Ticks a CPU had nothing to run, summed over CPUs */
+	simTime switchTime;			/* Ticks spent switching, summed over CPUs */
+	simTime queueArea;			/* Ready processes not on a CPU integrated over time, divide by length of run for the mean */
+	int maxQueue;				/* Most processes ready at one scheduling decision */
+	long long decisions;		/* Processes dispatched, kept only by builds with profiling (see profile.h) */
+	long long queueOps;			/* Processes put into or taken out of the ready set, likewise */
+	long long wakeups;			/* Processes back from I/O, likewise */
+}engineCounters;
+
+#endif /* COUNTERS_H_ */
@@ -0,0 +1,1141 @@
+/*
+ ============================================================================
+ Name        : engine.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Discrete event simulation core. Instead of stepping one tick
+               at a time the engine computes how long the selected process
+               can run before something happens (it finishes or blocks,
+               its quantum expires, a new process arrives or a blocked one
+               wakes) and jumps there directly.
+               Cost depends on number of scheduling events, not on burst
+               lengths. Counters of the run are kept on the same events.
+               One event loop serves every algorithm, each built-in one is
+               a schedPolicy (see policy.h) the loop is specialised for.
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "engine.h"
+#include "heap.h"
+#include "prioqueue.h"
+#include "rbtree.h"
+#include "timerwheel.h"
+#include "profile.h"
+
+/* Inlined into each caller, so a caller passing a constant policy gets its hooks called directly */
+#define ENGINE_INLINE static inline __attribute__((always_inline))
+
+/*
+ * Called when running is about to make progress. If another process ran last it counts a context switch (and a
+ * preemption if that one has not finished or blocked on I/O) and the CPU spends switchCost ticks switching while
+ * the given number of processes wait. Returns time at which running starts.
+ */
+static simTime contextSwitch(const procTable *t, int running, int *lastRun, int lastBlocked, simTime now,
+		simTime switchCost, int waiting, engineCounters *c, runCallback onRun, void *arg) {
+	if(*lastRun != IDLE_PROCESS && *lastRun != running) {
+		c->switches++;
+		if(t->burstTime[*lastRun] > 0 && !lastBlocked) {
+			c->preemptions++;
+		}
+		if(switchCost > 0) {
+			if(onRun) onRun(t, SWITCHING_PROCESS, now, switchCost, arg);
+			c->switchTime += switchCost;
+			c->queueArea += waiting * switchCost;
+			now += switchCost;
+		}
+	}
+	*lastRun = running;
+	return now;
+}
+
+/* Records state at a scheduling decision while no process holds the CPU: the ready set as the policy lists it */
+ENGINE_INLINE int saveCheckpoint(checkpointLog *log, const procTable *t, const schedPolicy *p, const void *s,
+		simTime now, int nextArrival, int done, int lastRun, const engineCounters *counters) {
+	int i, index;
+
+	if(checkpointBegin(log, now, nextArrival, done, lastRun, counters) != 0) {
+		return -1;
+	}
+	for(i=0; (index = p->ready(s, i)) != -1; i++) {
+		if(checkpointAdd(log, index, t->burstTime[index], t->startTime[index], t->IsActiveFor[index]) != 0) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Function Name: 	policyLoop
+ * Function:		Event loop of every algorithm. Admits arrivals, asks the policy what runs and for how long, pays
+ * 					context switches, advances the clock and keeps the process table and counters
+ * Input:			Process table sorted by arrivalTime (by priority for POLICY_ARRIVE_AT_ZERO), policy and its state
+ * 					(initialised), ticks per context switch, checkpoint log (NULL for none), checkpoint to resume from
+ * 					(-1 to start at 0), callback and its argument, counters to fill (NULL for none)
+ * Output:			Time at which last process finished, -1 if out of memory or the policy lost a process
+ * Affects:			burstTime (becomes zero), startTime, finishTime, waitingTime, IsActiveFor of every process, I/O
+ * 					columns of a table having them, log, counters, state of the policy
+ * NOTES:			Always inlined: with a constant policy every hook is a direct call the compiler may inline too.
+ * 					A process whose slice expired is handed back to the policy at the next decision, after the
+ * 					processes arriving by then, so they get in line before it.
+ * 					A process ending a CPU burst with I/O left blocks on a timer wheel till its I/O is over, then
+ * 					rejoins with its next CPU burst in burstTime. Blocked processes are not ready, so the queue
+ * 					counters leave them out. Tables with I/O cannot be checkpointed.
+ */
+
+ENGINE_INLINE simTime policyLoop(procTable *t, const schedPolicy *p, void *s, simTime switchCost, checkpointLog *log,
+		int resume, runCallback onRun, void *arg, engineCounters *counters) {
+	const checkpoint *cp;
+	const checkpointEntry *e;
+	engineCounters c;
+	timerWheel wheel;
+	simTime currentTime = 0, slice, arrival, nextCheckpoint = 0, runFrom, nextEvent, wakeAt, io;
+	int numOfProcesses = t->numOfProcesses, atZero = p->flags & POLICY_ARRIVE_AT_ZERO, hasIo = t->ioLeft != NULL;
+	int nextArrival = 0, done = 0, i, arrived, expired, woken, blocks, blocked = 0, lastBlocked = 0;
+	int running = IDLE_PROCESS, pending = IDLE_PROCESS, lastRun = IDLE_PROCESS;
+
+	memset(&c, 0, sizeof(c));
+	if(hasIo && (log || twInit(&wheel, numOfProcesses) != 0)) {
+		return -1;
+	}
+	if(log && resume >= 0) {
+		cp = &log->cp[resume];
+		currentTime = cp->time;
+		nextArrival = cp->nextArrival;
+		done = cp->done;
+		lastRun = cp->lastRun;
+		c = cp->counters;
+		nextCheckpoint = (currentTime / log->interval + 1) * log->interval;	/*Resumed one is kept*/
+		for(i=0; i<cp->count; i++) {
+			e = &log->entry[cp->first + i];
+			t->burstTime[e->index] = e->remaining;
+			t->startTime[e->index] = e->startTime;
+			t->IsActiveFor[e->index] = e->ran;
+			p->enqueue(s, t, e->index, currentTime);	/*Ready set is rebuilt in the order it was listed*/
+		}
+	}
+	for(i=nextArrival; i<numOfProcesses; i++) {
+		t->startTime[i] = -1;
+		t->IsActiveFor[i] = 0;
+	}
+
+	while(done < numOfProcesses) {
+		if(p->tick) {
+			p->tick(s, t, currentTime, running);
+		}
+
+		/*
+		 * Move every process which has arrived by now into the ready set, counting its wait since arrival. Those
+		 * whose I/O is over join in time order with them, an arrival first at the same tick
+		 */
+		arrived = 0;
+		if(hasIo) {
+			twAdvance(&wheel, currentTime);
+		}
+		for(;;) {
+			woken = hasIo ? twFirst(&wheel) : -1;
+			if(nextArrival < numOfProcesses && (atZero || t->arrivalTime[nextArrival] <= currentTime) &&
+					(woken < 0 || atZero || t->arrivalTime[nextArrival] <= wheel.expiry[woken])) {
+				if(!atZero) {
+					c.queueArea += currentTime - t->arrivalTime[nextArrival];
+				}
+				p->enqueue(s, t, nextArrival++, currentTime);
+			} else if(woken >= 0) {
+				wakeAt = wheel.expiry[twPop(&wheel)];
+				c.queueArea += currentTime - wakeAt;
+				blocked--;
+				PROF_TALLY(c.wakeups++);
+				if(p->wake) {
+					p->wake(s, t, woken, wakeAt);
+				} else {
+					p->enqueue(s, t, woken, currentTime);
+				}
+			} else {
+				break;
+			}
+			arrived = 1;
+			PROF_TALLY(c.queueOps++);
+		}
+		if(pending != IDLE_PROCESS) {
+			p->onPreempt(s, t, pending, 1, currentTime);
+			pending = IDLE_PROCESS;
+			PROF_TALLY(c.queueOps++);
+		}
+		if(nextArrival - done - blocked > c.maxQueue) {
+			c.maxQueue = nextArrival - done - blocked;
+		}
+
+		if(log && running == IDLE_PROCESS && currentTime >= nextCheckpoint) {
+			if(saveCheckpoint(log, t, p, s, currentTime, nextArrival, done, lastRun, &c) != 0) {
+				currentTime = -1;
+				break;
+			}
+			nextCheckpoint = (currentTime / log->interval + 1) * log->interval;
+		}
+
+		if(running != IDLE_PROCESS && p->preempt && p->preempt(s, t, running, arrived, currentTime)) {
+			p->onPreempt(s, t, running, 0, currentTime);
+			running = IDLE_PROCESS;
+			PROF_TALLY(c.queueOps++);
+		}
+		/*Next arrival or wakeup, -1 if none is left*/
+		nextEvent = nextArrival < numOfProcesses ? t->arrivalTime[nextArrival] : -1;
+		if(blocked > 0 && ((wakeAt = twNext(&wheel)) < nextEvent || nextEvent < 0)) {
+			nextEvent = wakeAt;
+		}
+
+		if(running == IDLE_PROCESS) {
+			running = p->pickNext(s, t, currentTime);
+			PROF_TALLY(c.queueOps++);
+			if(running < 0) {
+				running = IDLE_PROCESS;
+				if(nextEvent < 0) {
+					currentTime = -1;		/*Policy dropped a process it was given*/
+					break;
+				}
+				/*Nothing to run, jump over the idle gap till next arrival*/
+				if(onRun) onRun(t, IDLE_PROCESS, currentTime, nextEvent - currentTime, arg);
+				c.idleTime += nextEvent - currentTime;
+				currentTime = nextEvent;
+				continue;
+			}
+		}
+
+		/*How long can it run before next scheduling decision*/
+		slice = p->slice(s, t, running, currentTime, nextEvent);
+		if(slice < 0) {
+			currentTime = -1;
+			break;
+		}
+		if(slice == 0 && t->burstTime[running] > 0) {
+			pending = running;		/*Gives the CPU back unused*/
+			running = IDLE_PROCESS;
+			continue;
+		}
+
+		if(slice > 0) {
+			runFrom = contextSwitch(t, running, &lastRun, lastBlocked, currentTime, switchCost,
+					nextArrival - done - blocked - 1, &c, onRun, arg);
+			lastBlocked = 0;
+			if(runFrom > currentTime && p->preempt) {
+				currentTime = runFrom;		/*Arrivals while switching may call for another process*/
+				continue;
+			}
+			currentTime = runFrom;
+			if(onRun) onRun(t, running, currentTime, slice, arg);
+			c.queueArea += (simTime)(nextArrival - done - blocked - 1) * slice;
+			PROF_TALLY(c.decisions++);
+			PROF_DISPATCH(c.decisions, running, currentTime, slice);
+		}
+
+		/*Keep record of startTime*/
+		if(t->startTime[running] == -1) {
+			t->startTime[running] = currentTime;
+		}
+		currentTime += slice;
+		t->burstTime[running] -= slice;
+		t->IsActiveFor[running] += slice;
+		expired = p->ran ? p->ran(s, t, running, slice, currentTime) : 0;
+
+		if(t->burstTime[running] == 0) {
+			blocks = hasIo && t->ioLeft[running] > 0;
+			if(!blocks) {
+				/*Stores finish time and waiting time i.e. time spent by process before it was first picked*/
+				t->finishTime[running] = currentTime;
+				arrival = atZero ? 0 : t->arrivalTime[running];
+				t->waitingTime[running] = t->startTime[running] - arrival;
+				done++;
+			}
+			if(p->finish) {
+				p->finish(s, t, running, currentTime);
+			}
+			if(blocks) {
+				/*Blocks till its I/O is over, its next CPU burst waits in burstTime*/
+				io = t->bursts[t->nextBurst[running]];
+				t->burstTime[running] = t->bursts[t->nextBurst[running] + 1];
+				t->nextBurst[running] += 2;
+				t->ioLeft[running]--;
+				t->ioTime[running] += io;
+				twAdd(&wheel, running, currentTime + io);
+				blocked++;
+				lastBlocked = 1;
+			}
+			running = IDLE_PROCESS;
+		} else if(expired) {
+			pending = running;
+			running = IDLE_PROCESS;
+		}
+	}
+
+	if(hasIo) {
+		twFree(&wheel);
+	}
+	if(counters) {
+		*counters = c;
+	}
+	return currentTime;
+}
+
+/* Runs the loop on zeroed state of the policy, set up by its init and released after */
+ENGINE_INLINE simTime runPolicy(procTable *t, const schedPolicy *p, const void *params, simTime switchCost,
+		checkpointLog *log, int resume, runCallback onRun, void *arg, engineCounters *counters) {
+	void *s = calloc(1, p->stateSize > 0 ? p->stateSize : 1);
+	simTime end = -1;
+
+	if(s && (p->init == NULL || p->init(s, t, params) == 0)) {
+		end = policyLoop(t, p, s, switchCost, log, resume, onRun, arg, counters);
+		if(p->release) {
+			p->release(s);
+		}
+	}
+	free(s);
+	return end;
+}
+
+/*
+ * Defines a run function of a built-in policy. Its copy of the loop calls the hooks directly, so no indirect call is
+ * left on the hot path.
+ */
+#define POLICY_RUNNER(name, policy) \
+	static simTime name(procTable *t, const void *params, simTime switchCost, checkpointLog *log, int resume, \
+			runCallback onRun, void *arg, engineCounters *counters) { \
+		return runPolicy(t, &policy, params, switchCost, log, resume, onRun, arg, counters); \
+	}
+
+/*
+ * First Come First Serve and Priority Based share one FIFO, kept as a ring buffer. It never holds more than
+ * numOfProcesses entries.
+ */
+typedef struct {
+	int *slot;
+	int head;
+	int count;
+	int size;
+}readyQueue;
+
+static void rqPush(readyQueue *rq, int index) {
+	rq->slot[(rq->head + rq->count) % rq->size] = index;
+	rq->count++;
+}
+
+static int rqPop(readyQueue *rq) {
+	int index = rq->slot[rq->head];
+	rq->head = (rq->head + 1) % rq->size;
+	rq->count--;
+	return index;
+}
+
+static int fifoInit(void *s, const procTable *t, const void *params) {
+	readyQueue *rq = s;
+
+	rq->size = t->numOfProcesses > 0 ? t->numOfProcesses : 1;
+	rq->slot = malloc(rq->size * sizeof(int));
+	return rq->slot ? 0 : -1;
+}
+
+static void fifoRelease(void *s) {
+	free(((readyQueue *)s)->slot);
+}
+
+static void fifoEnqueue(void *s, const procTable *t, int index, simTime now) {
+	rqPush(s, index);
+}
+
+static void fifoRequeue(void *s, const procTable *t, int index, int expired, simTime now) {
+	rqPush(s, index);
+}
+
+static int fifoPick(void *s, const procTable *t, simTime now) {
+	readyQueue *rq = s;
+
+	return rq->count > 0 ? rqPop(rq) : -1;
+}
+
+static simTime fifoSlice(void *s, const procTable *t, int running, simTime now, simTime nextArrival) {
+	return t->burstTime[running];
+}
+
+static int fifoReady(const void *s, int i) {
+	const readyQueue *rq = s;
+
+	return i < rq->count ? rq->slot[(rq->head + i) % rq->size] : -1;
+}
+
+static const schedPolicy fcfsPolicy = {
+	"fcfs", sizeof(readyQueue), 0, fifoInit, fifoRelease, NULL, fifoEnqueue, NULL, fifoRequeue, fifoPick,
+	fifoSlice, NULL, NULL, fifoReady
+};
+
+static const schedPolicy priorityPolicy = {
+	"priority", sizeof(readyQueue), POLICY_ARRIVE_AT_ZERO, fifoInit, fifoRelease, NULL, fifoEnqueue, NULL, fifoRequeue,
+	fifoPick, fifoSlice, NULL, NULL, fifoReady
+};
+
+/*
+ * Round Robin walks the table in arrival order, giving every ready process a quantum and starting over after the last
+ * one, as the tick loop did. Ready processes sit in a heap keyed on the round of the walk they run in, ties going to
+ * arrival order: one after the process picked last runs in its round, one up to it in the next round.
+ */
+typedef struct {
+	minHeap h;
+	int *order;					/* Ready set in walk order, filled when it is listed */
+	simTime quantum;
+	long long round;			/* Round of the process picked last */
+	int last;					/* Process picked last, -1 before the first pick */
+	int lastIn;					/* Process enqueued last, -1 if none */
+}rrQueue;
+
+/* Parameters: time quantum */
+static int rrInit(void *s, const procTable *t, const void *params) {
+	rrQueue *rq = s;
+
+	rq->quantum = *(const simTime *)params;
+	rq->last = rq->lastIn = -1;
+	rq->order = malloc((t->numOfProcesses > 0 ? t->numOfProcesses : 1) * sizeof(int));
+	if(rq->order == NULL || heapInit(&rq->h, t->numOfProcesses) != 0) {
+		free(rq->order);
+		return -1;
+	}
+	return 0;
+}
+
+static void rrRelease(void *s) {
+	rrQueue *rq = s;
+
+	heapFree(&rq->h);
+	free(rq->order);
+}
+
+static void rrEnqueue(void *s, const procTable *t, int index, simTime now) {
+	rrQueue *rq = s;
+
+	/*A ready set restored from a checkpoint comes in walk order, going down where it wraps to the next round*/
+	if(rq->last < 0 && index < rq->lastIn) {
+		rq->last = rq->lastIn;
+	}
+	rq->lastIn = index;
+	heapPush(&rq->h, index, index > rq->last ? rq->round : rq->round + 1);
+}
+
+/* Expired one waits for the next round, processes after it in arrival order run first */
+static void rrRequeue(void *s, const procTable *t, int index, int expired, simTime now) {
+	rrEnqueue(s, t, index, now);
+}
+
+static int rrPick(void *s, const procTable *t, simTime now) {
+	rrQueue *rq = s;
+
+	if(rq->h.count == 0) {
+		return -1;
+	}
+	rq->round = rq->h.key[heapTop(&rq->h)];
+	return rq->last = heapPop(&rq->h);
+}
+
+static simTime rrSlice(void *s, const procTable *t, int running, simTime now, simTime nextArrival) {
+	simTime quantum = ((rrQueue *)s)->quantum;
+
+	return t->burstTime[running] < quantum ? t->burstTime[running] : quantum;
+}
+
+static int rrExpire(void *s, const procTable *t, int running, simTime ran, simTime now) {
+	return 1;
+}
+
+static int byIndex(const void *a, const void *b) {
+	return *(const int *)a - *(const int *)b;
+}
+
+/* Lists processes of this round, then those of the next one, each in arrival order */
+static int rrReady(const void *s, int i) {
+	const rrQueue *rq = s;
+	int j, first = 0, next = rq->h.count;
+
+	if(i >= rq->h.count) {
+		return -1;
+	}
+	if(i == 0) {
+		for(j=0; j<rq->h.count; j++) {
+			if(rq->h.key[rq->h.slot[j]] == rq->round) {
+				rq->order[first++] = rq->h.slot[j];
+			} else {
+				rq->order[--next] = rq->h.slot[j];
+			}
+		}
+		qsort(rq->order, first, sizeof(int), byIndex);
+		qsort(rq->order + first, rq->h.count - first, sizeof(int), byIndex);
+	}
+	return rq->order[i];
+}
+
+static const schedPolicy rrPolicy = {
+	"rr", sizeof(rrQueue), 0, rrInit, rrRelease, NULL, rrEnqueue, NULL, rrRequeue, rrPick,
+	rrSlice, rrExpire, NULL, rrReady
+};
+
+/*
+ * Shortest Job First (Preemptive): ready processes in a heap keyed on remaining burst, ties go to earlier arrival. The
+ * running process stays on top of the heap till it finishes and its key is lowered when it is handed back.
+ */
+static int sjfInit(void *s, const procTable *t, const void *params) {
+	return heapInit(s, t->numOfProcesses);
+}
+
+static void sjfRelease(void *s) {
+	heapFree(s);
+}
+
+static void sjfEnqueue(void *s, const procTable *t, int index, simTime now) {
+	heapPush(s, index, t->burstTime[index]);
+}
+
+static void sjfRequeue(void *s, const procTable *t, int index, int expired, simTime now) {
+	heapDecreaseKey(s, index, t->burstTime[index]);
+}
+
+/* Asked after arrivals while switching to running: is it still on top? */
+static int sjfPreempt(void *s, const procTable *t, int running, int arrived, simTime now) {
+	return heapTop(s) != running;
+}
+
+static int sjfPick(void *s, const procTable *t, simTime now) {
+	const minHeap *h = s;
+
+	return h->count > 0 ? heapTop(h) : -1;
+}
+
+static simTime sjfSlice(void *s, const procTable *t, int running, simTime now, simTime nextArrival) {
+	simTime slice = t->burstTime[running];
+
+	if(nextArrival >= 0 && nextArrival < now + slice) {
+		slice = nextArrival - now;		/*Newcomer may be shorter, decide again at its arrival*/
+	}
+	return slice;
+}
+
+static int sjfExpire(void *s, const procTable *t, int running, simTime ran, simTime now) {
+	return 1;
+}
+
+static void sjfFinish(void *s, const procTable *t, int index, simTime now) {
+	heapPop(s);
+}
+
+static int sjfReady(const void *s, int i) {
+	const minHeap *h = s;
+
+	return i < h->count ? h->slot[i] : -1;		/*Pushing them back in heap order rebuilds the same heap*/
+}
+
+static const schedPolicy sjfPolicy = {
+	"sjfp", sizeof(minHeap), 0, sjfInit, sjfRelease, NULL, sjfEnqueue, sjfPreempt, sjfRequeue, sjfPick,
+	sjfSlice, sjfExpire, sjfFinish, sjfReady
+};
+
+POLICY_RUNNER(runFcfs, fcfsPolicy)
+POLICY_RUNNER(runSjf, sjfPolicy)
+POLICY_RUNNER(runPriority, priorityPolicy)
+POLICY_RUNNER(runRr, rrPolicy)
+
+/**
+ * Function Name: 	simulate
+ * Function:		Runs given scheduling algorithm over the process table using discrete events
+ * Input:			Process table sorted by arrivalTime (by priority for ALGO_PRIORITY), algorithm,
+ * 					time quantum (Round Robin only), callback for every run of the CPU and its argument
+ * Output:			Time at which last process finished, -1 if out of memory
+ * Affects:			burstTime (becomes zero), startTime, finishTime, waitingTime, IsActiveFor of every process
+ * NOTES:			For ALGO_PRIORITY arrivalTime holds priority, so every process is taken as arrived at 0.
+ */
+
+simTime simulate(procTable *t, int algo, simTime timeQuanta, runCallback onRun, void *arg) {
+	return simulateFrom(t, algo, timeQuanta, 0, NULL, -1, onRun, arg, NULL);
+}
+
+/**
+ * Function Name: 	simulateFrom
+ * Function:		simulate() with a cost for every context switch, taking a checkpoint every log->interval ticks or
+ * 					resuming from one. Resuming restores clock, counters and ready queue of the checkpoint and runs
+ * 					only what follows it
+ * Input:			Process table as for simulate(), algorithm (not ALGO_PRIORITY when log is given), time quantum,
+ * 					ticks per context switch, checkpoint log (NULL for none), checkpoint to resume from (-1 to start
+ * 					at 0), callback and its argument, counters to fill (NULL for none)
+ * Output:			Time at which last process finished, -1 if out of memory or algorithm is not one of simulate()
+ * Affects:			Process table as simulate() does, log (checkpoints after the one resumed from are appended), counters
+ * NOTES:			startTime is when the process first made progress, after the switch to it.
+ * 			When resuming, processes before nextArrival of the checkpoint must already hold their final
+ * 					startTime, finishTime, waitingTime and IsActiveFor from the run that took it, and zero burstTime;
+ * 					those queued at the checkpoint are restored from it. Processes after it are as for simulate().
+ */
+
+simTime simulateFrom(procTable *t, int algo, simTime timeQuanta, simTime switchCost, checkpointLog *log, int resume,
+		runCallback onRun, void *arg, engineCounters *counters) {
+	switch(algo) {
+	case ALGO_FCFS:
+		return runFcfs(t, NULL, switchCost, log, resume, onRun, arg, counters);
+	case ALGO_SJFP:
+		return runSjf(t, NULL, switchCost, log, resume, onRun, arg, counters);
+	case ALGO_PRIORITY:
+		return runPriority(t, NULL, switchCost, log, resume, onRun, arg, counters);
+	case ALGO_RR:
+		return runRr(t, &timeQuanta, switchCost, log, resume, onRun, arg, counters);
+	}
+	return -1;
+}
+
+/* Preemptive Priority: levels of waiting processes, with the level the running one was picked at */
+typedef struct {
+	prioQueue pq;
+	simTime agingInterval;
+	int runLevel;
+	int maxLevel;
+}prioState;
+
+/* Parameters: aging interval, 0 = none */
+static int prioStateInit(void *s, const procTable *t, const void *params) {
+	prioState *ps = s;
+	int minLevel = 0, i;
+
+	for(i=0; i<t->numOfProcesses; i++) {
+		if(i == 0 || t->priority[i] < minLevel) minLevel = t->priority[i];
+		if(i == 0 || t->priority[i] > ps->maxLevel) ps->maxLevel = t->priority[i];
+	}
+	ps->agingInterval = *(const simTime *)params;
+	return prioInit(&ps->pq, t->numOfProcesses, minLevel, ps->maxLevel);
+}
+
+static void prioStateRelease(void *s) {
+	prioFree(&((prioState *)s)->pq);
+}
+
+/* Ages those already waiting before newcomers join */
+static void prioTick(void *s, const procTable *t, simTime now, int running) {
+	prioState *ps = s;
+
+	if(ps->agingInterval > 0) {
+		prioAge(&ps->pq, now / ps->agingInterval);
+	}
+}
+
+static void prioEnqueue(void *s, const procTable *t, int index, simTime now) {
+	prioPush(&((prioState *)s)->pq, index, t->priority[index], 0);
+}
+
+static int prioPreempt(void *s, const procTable *t, int running, int arrived, simTime now) {
+	prioState *ps = s;
+
+	return ps->pq.count > 0 && prioTopLevel(&ps->pq) > ps->runLevel;
+}
+
+/* Goes back to head of the level it ran at */
+static void prioRequeue(void *s, const procTable *t, int index, int expired, simTime now) {
+	prioState *ps = s;
+
+	prioPush(&ps->pq, index, ps->runLevel, 1);
+}
+
+static int prioPick(void *s, const procTable *t, simTime now) {
+	prioState *ps = s;
+
+	if(ps->pq.count == 0) {
+		return -1;
+	}
+	ps->runLevel = prioTopLevel(&ps->pq);
+	return prioPop(&ps->pq);
+}
+
+/* Runs till it finishes, next arrival or the aging step lifting highest waiting process above it */
+static simTime prioSlice(void *s, const procTable *t, int running, simTime now, simTime nextArrival) {
+	prioState *ps = s;
+	simTime slice = t->burstTime[running], tick;
+
+	if(nextArrival >= 0 && nextArrival - now < slice) {
+		slice = nextArrival - now;
+	}
+	if(ps->agingInterval > 0 && ps->pq.count > 0 && ps->runLevel < ps->maxLevel) {
+		tick = (now / ps->agingInterval + ps->runLevel - prioTopLevel(&ps->pq) + 1) * ps->agingInterval - now;
+		if(tick < slice) {
+			slice = tick;
+		}
+	}
+	return slice;
+}
+
+static const schedPolicy ppriorityPolicy = {
+	"ppriority", sizeof(prioState), 0, prioStateInit, prioStateRelease, prioTick, prioEnqueue, prioPreempt, prioRequeue,
+	prioPick, prioSlice, NULL, NULL, NULL
+};
+
+POLICY_RUNNER(runPpriority, ppriorityPolicy)
+
+/**
+ * Function Name: 	simulatePriority
+ * Function:		Runs Preemptive Priority over the process table using discrete events. A process arriving with
+ * 					higher priority than the running one preempts it; the preempted process goes back to the head
+ * 					of its level. With aging every waiting process gains one level at every multiple of
+ * 					agingInterval ticks of simulated time, up to the highest priority of the table, and keeps the
+ * 					level it reached while it runs and if it is preempted. Its first level may so come after less
+ * 					than agingInterval ticks of waiting.
+ * Input:			Process table sorted by arrivalTime, aging interval (0 = no aging), ticks per context switch,
+ * 					callback for every run of the CPU and its argument, counters to fill (NULL for none)
+ * Output:			Time at which last process finished, -1 if out of memory or priorities span too many levels
+ * Affects:			burstTime (becomes zero), startTime, finishTime, waitingTime, IsActiveFor of every process, counters
+ */
+
+simTime simulatePriority(procTable *t, simTime agingInterval, simTime switchCost, runCallback onRun, void *arg,
+		engineCounters *counters) {
+	return runPpriority(t, &agingInterval, switchCost, NULL, -1, onRun, arg, counters);
+}
+
+/* FIFOs of MLFQ levels, linked through next[]. Bit l of nonEmpty is set while level l has processes */
+typedef struct {
+	int *next;
+	int head[MLFQ_MAX_LEVELS];
+	int tail[MLFQ_MAX_LEVELS];
+	unsigned nonEmpty;
+}levelQueues;
+
+static void levelPush(levelQueues *lq, int level, int index, int atHead) {
+	if(lq->head[level] == -1) {
+		lq->next[index] = -1;
+		lq->head[level] = lq->tail[level] = index;
+		lq->nonEmpty |= 1u << level;
+	} else if(atHead) {
+		lq->next[index] = lq->head[level];
+		lq->head[level] = index;
+	} else {
+		lq->next[index] = -1;
+		lq->next[lq->tail[level]] = index;
+		lq->tail[level] = index;
+	}
+}
+
+static int levelPop(levelQueues *lq, int level) {
+	int index = lq->head[level];
+
+	lq->head[level] = lq->next[index];
+	if(lq->head[level] == -1) {
+		lq->nonEmpty &= ~(1u << level);
+	}
+	return index;
+}
+
+/* Appends every lower level to level 0, keeping their order */
+static void levelBoost(levelQueues *lq, int levels) {
+	int l;
+
+	for(l=1; l<levels; l++) {
+		if(lq->head[l] == -1) {
+			continue;
+		}
+		if(lq->head[0] == -1) {
+			lq->head[0] = lq->head[l];
+		} else {
+			lq->next[lq->tail[0]] = lq->head[l];
+		}
+		lq->tail[0] = lq->tail[l];
+		lq->head[l] = -1;
+	}
+	if(lq->nonEmpty) {
+		lq->nonEmpty = 1;
+	}
+}
+
+/*
+ * Multilevel Feedback Queue. A boost falls due at a tick but its splice waits till arrivals before it have joined
+ * level 0 (boostPending), so they go first. A process learns it was boosted from the boost count stored when it
+ * was queued, so no step walks all processes.
+ */
+typedef struct {
+	levelQueues lq;
+	const mlfqParams *mp;
+	simTime *used;				/* Of the quantum of its level */
+	int *level;
+	int *boostsSeen;
+	int boosts;
+	simTime nextBoost;			/* -1 = never */
+	simTime boostAt;			/* Time of pending boost */
+	int boostPending;
+	int demoted;				/* Process whose quantum just expired, till it is queued again */
+}mlfqState;
+
+/* Parameters: mlfqParams */
+static int mlfqInit(void *s, const procTable *t, const void *params) {
+	mlfqState *ms = s;
+	int n = t->numOfProcesses > 0 ? t->numOfProcesses : 1, l;
+
+	ms->mp = params;
+	if(ms->mp->levels < 1 || ms->mp->levels > MLFQ_MAX_LEVELS) {
+		return -1;
+	}
+	for(l=0; l<ms->mp->levels; l++) {
+		if(ms->mp->quantum[l] <= 0) {
+			return -1;
+		}
+		ms->lq.head[l] = -1;
+	}
+	ms->used = malloc(n * (sizeof(simTime) + 3 * sizeof(int)));	/*One allocation for all four arrays*/
+	if(ms->used == NULL) {
+		return -1;
+	}
+	ms->lq.next = (int *)(ms->used + n);
+	ms->level = ms->lq.next + n;
+	ms->boostsSeen = ms->level + n;
+	ms->nextBoost = ms->mp->boostInterval > 0 ? ms->mp->boostInterval : -1;
+	ms->demoted = IDLE_PROCESS;
+	return 0;
+}
+
+static void mlfqRelease(void *s) {
+	free(((mlfqState *)s)->used);
+}
+
+/* Splices lower levels into level 0 if a boost is pending */
+static void mlfqSettle(mlfqState *ms) {
+	if(ms->boostPending) {
+		levelBoost(&ms->lq, ms->mp->levels);
+		ms->boosts++;
+		ms->boostPending = 0;
+	}
+}
+
+/* Periodic boost: everybody back to level 0, queued ones lazily */
+static void mlfqTick(void *s, const procTable *t, simTime now, int running) {
+	mlfqState *ms = s;
+
+	if(ms->nextBoost >= 0 && now >= ms->nextBoost) {
+		ms->boostAt = ms->nextBoost;
+		ms->boostPending = 1;
+		if(running != IDLE_PROCESS) {
+			ms->level[running] = 0;
+			ms->used[running] = 0;
+		}
+		if(ms->demoted != IDLE_PROCESS) {
+			ms->level[ms->demoted] = 0;
+		}
+		ms->nextBoost = (now / ms->mp->boostInterval + 1) * ms->mp->boostInterval;
+	}
+}
+
+/* Arrivals join level 0, those arrived before a pending boost ahead of the processes it lifts */
+static void mlfqEnqueue(void *s, const procTable *t, int index, simTime now) {
+	mlfqState *ms = s;
+
+	if(ms->boostPending && t->arrivalTime[index] >= ms->boostAt) {
+		mlfqSettle(ms);
+	}
+	ms->used[index] = 0;
+	ms->boostsSeen[index] = ms->boosts;
+	levelPush(&ms->lq, 0, index, 0);
+}
+
+/* Leaves the CPU for good or till its I/O is over: remembers which boosts it has had */
+static void mlfqFinish(void *s, const procTable *t, int index, simTime now) {
+	mlfqState *ms = s;
+
+	ms->boostsSeen[index] = ms->boosts + ms->boostPending;
+}
+
+/*
+ * Back from I/O: keeps its level and what it used of the quantum there, so blocking just before the quantum runs
+ * out does not escape demotion, unless a boost came while it was blocked
+ */
+static void mlfqWake(void *s, const procTable *t, int index, simTime wokeAt) {
+	mlfqState *ms = s;
+
+	if(ms->boostPending && wokeAt >= ms->boostAt) {
+		mlfqSettle(ms);
+	}
+	if(ms->boostsSeen[index] != ms->boosts + ms->boostPending) {
+		ms->level[index] = 0;
+		ms->used[index] = 0;
+	}
+	ms->boostsSeen[index] = ms->boosts;
+	levelPush(&ms->lq, ms->level[index], index, 0);
+}
+
+/* A higher level has work */
+static int mlfqPreempt(void *s, const procTable *t, int running, int arrived, simTime now) {
+	mlfqState *ms = s;
+
+	mlfqSettle(ms);
+	return ms->lq.nonEmpty && __builtin_ctz(ms->lq.nonEmpty) < ms->level[running];
+}
+
+/* Demoted one goes to the tail of its new level with a fresh quantum, preempted one resumes first in its level */
+static void mlfqRequeue(void *s, const procTable *t, int index, int expired, simTime now) {
+	mlfqState *ms = s;
+
+	mlfqSettle(ms);
+	ms->boostsSeen[index] = ms->boosts;
+	if(expired) {
+		ms->used[index] = 0;
+		ms->demoted = IDLE_PROCESS;
+	}
+	levelPush(&ms->lq, ms->level[index], index, !expired);
+}
+
+static int mlfqPick(void *s, const procTable *t, simTime now) {
+	mlfqState *ms = s;
+	int l, index;
+
+	mlfqSettle(ms);
+	if(ms->lq.nonEmpty == 0) {
+		return -1;
+	}
+	l = __builtin_ctz(ms->lq.nonEmpty);
+	index = levelPop(&ms->lq, l);
+	ms->level[index] = l;
+	if(ms->boostsSeen[index] != ms->boosts) {
+		ms->used[index] = 0;		/*Boosted while waiting*/
+	}
+	return index;
+}
+
+/* Runs till quantum of its level is used, it finishes, an arrival may preempt it or next boost */
+static simTime mlfqSlice(void *s, const procTable *t, int running, simTime now, simTime nextArrival) {
+	mlfqState *ms = s;
+	simTime slice = ms->mp->quantum[ms->level[running]] - ms->used[running];
+
+	if(t->burstTime[running] < slice) {
+		slice = t->burstTime[running];
+	}
+	if(ms->level[running] > 0 && nextArrival >= 0 && nextArrival - now < slice) {
+		slice = nextArrival - now;
+	}
+	if(ms->nextBoost >= 0 && ms->nextBoost - now < slice) {
+		slice = ms->nextBoost - now;
+	}
+	return slice;
+}
+
+/* Using up the quantum demotes it one level, the lowest one keeps it */
+static int mlfqRan(void *s, const procTable *t, int running, simTime ran, simTime now) {
+	mlfqState *ms = s;
+
+	ms->used[running] += ran;
+	if(t->burstTime[running] == 0 || ms->used[running] != ms->mp->quantum[ms->level[running]]) {
+		return 0;
+	}
+	if(ms->level[running] < ms->mp->levels - 1) {
+		ms->level[running]++;
+	}
+	ms->demoted = running;
+	return 1;
+}
+
+static const schedPolicy mlfqPolicy = {
+	"mlfq", sizeof(mlfqState), 0, mlfqInit, mlfqRelease, mlfqTick, mlfqEnqueue, mlfqPreempt, mlfqRequeue, mlfqPick,
+	mlfqSlice, mlfqRan, mlfqFinish, NULL, mlfqWake
+};
+
+POLICY_RUNNER(runMlfq, mlfqPolicy)
+
+/**
+ * Function Name: 	simulateMlfq
+ * Function:		Runs Multilevel Feedback Queue over the process table using discrete events. Arrivals join
+ * 					level 0; the highest non-empty level runs Round Robin. A process using up the quantum of its
+ * 					level is demoted one level (the lowest one keeps it), a process at a lower level is preempted
+ * 					by an arrival and resumes first in its level with the rest of its quantum. Every
+ * 					boostInterval ticks all processes go back to level 0 with a fresh quantum.
+ * Input:			Process table sorted by arrivalTime, levels and quanta, ticks per context switch, callback for
+ * 					every run of the CPU and its argument, counters to fill (NULL for none)
+ * Output:			Time at which last process finished, -1 if out of memory or levels or quanta are invalid
+ * Affects:			burstTime (becomes zero), startTime, finishTime, waitingTime, IsActiveFor of every process, counters
+ * NOTES:			Boost resets levels lazily: FIFOs are spliced in O(levels) and a process learns it was boosted
+ * 					from the boost count stored when it was queued, so no step walks all processes.
+ */
+
+simTime simulateMlfq(procTable *t, const mlfqParams *mp, simTime switchCost, runCallback onRun, void *arg,
+		engineCounters *counters) {
+	return runMlfq(t, mp, switchCost, NULL, -1, onRun, arg, counters);
+}
+
+/* Load weight of nice levels -20..19 as in Linux, nice 0 weighs CFS_NICE0_WEIGHT and each level is ~10% of CPU */
+static const int cfsWeight[40] = {
+	88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+	 9548,  7620,  6100,  4904,  3906,  3121,  2501,  1991,  1586,  1277,
+	 1024,   820,   655,   526,   423,   335,   272,   215,   172,   137,
+	  110,    87,    70,    56,    45,    36,    29,    23,    18,    15
+};
+
+#define CFS_NICE0_WEIGHT 1024
+#define CFS_VRUNTIME_SHIFT 20		/* Virtual runtime is kept in 1/1024 tick units of a nice 0 process */
+
+/* Weight of a process, higher priority is lower nice */
+static int cfsWeightOf(const procTable *t, int index) {
+	int nice = -t->priority[index];
+
+	if(nice < -20) nice = -20;
+	if(nice > 19) nice = 19;
+	return cfsWeight[nice + 20];
+}
+
+/* Completely Fair Scheduler: ready processes in a tree keyed on virtual runtime */
+typedef struct {
+	rbTree tree;
+	const cfsParams *cp;
+	long long *vruntime;
+	long long minVruntime;
+	long long totalWeight;		/* Of ready and running processes */
+	simTime ran;				/* By running process since it was picked */
+	simTime sliceLen;			/* Its share of the period */
+}cfsState;
+
+/* Parameters: cfsParams */
+static int cfsInit(void *s, const procTable *t, const void *params) {
+	cfsState *cs = s;
+
+	cs->cp = params;
+	if(cs->cp->latency <= 0 || cs->cp->minGranularity <= 0) {
+		return -1;
+	}
+	cs->vruntime = calloc(t->numOfProcesses > 0 ? t->numOfProcesses : 1, sizeof(long long));
+	if(cs->vruntime == NULL) {
+		return -1;
+	}
+	if(rbInit(&cs->tree, t->numOfProcesses, cs->vruntime) != 0) {
+		free(cs->vruntime);
+		return -1;
+	}
+	return 0;
+}
+
+static void cfsRelease(void *s) {
+	cfsState *cs = s;
+
+	rbFree(&cs->tree);
+	free(cs->vruntime);
+}
+
+/*
+ * Newcomers start level with the slowest runner so they neither starve nor monopolise the CPU. A process back
+ * from I/O keeps its virtual runtime unless it fell behind that, so sleeping earns no credit
+ */
+static void cfsEnqueue(void *s, const procTable *t, int index, simTime now) {
+	cfsState *cs = s;
+
+	if(cs->vruntime[index] < cs->minVruntime) {
+		cs->vruntime[index] = cs->minVruntime;
+	}
+	cs->totalWeight += cfsWeightOf(t, index);
+	rbInsert(&cs->tree, index);
+}
+
+/* Wakeup preemption: running process is too far ahead of the leftmost one */
+static int cfsPreempt(void *s, const procTable *t, int running, int arrived, simTime now) {
+	cfsState *cs = s;
+
+	return arrived && cs->vruntime[rbFirst(&cs->tree)] + (cs->cp->minGranularity << (CFS_VRUNTIME_SHIFT - 10)) <
+			cs->vruntime[running];
+}
+
+static void cfsRequeue(void *s, const procTable *t, int index, int expired, simTime now) {
+	rbInsert(&((cfsState *)s)->tree, index);
+}
+
+static int cfsPick(void *s, const procTable *t, simTime now) {
+	cfsState *cs = s;
+	int index = rbFirst(&cs->tree);
+
+	if(index != -1) {
+		rbRemove(&cs->tree, index);
+		cs->ran = 0;
+	}
+	return index;
+}
+
+/* Its share of the period as of now, run till it finishes, the share is used or next arrival */
+static simTime cfsSlice(void *s, const procTable *t, int running, simTime now, simTime nextArrival) {
+	cfsState *cs = s;
+	simTime period = cs->cp->latency, slice;
+
+	if((cs->tree.count + 1) * cs->cp->minGranularity > period) {
+		period = (cs->tree.count + 1) * cs->cp->minGranularity;		/*Processes counted include itself*/
+	}
+	cs->sliceLen = period * cfsWeightOf(t, running) / cs->totalWeight;
+	if(cs->sliceLen < 1) {
+		cs->sliceLen = 1;
+	}
+	if(cs->ran >= cs->sliceLen) {
+		return 0;		/*Arrivals shrank its share below what it has used*/
+	}
+	slice = cs->sliceLen - cs->ran;
+	if(t->burstTime[running] < slice) {
+		slice = t->burstTime[running];
+	}
+	if(nextArrival >= 0 && nextArrival - now < slice) {
+		slice = nextArrival - now;
+	}
+	return slice;
+}
+
+static int cfsRan(void *s, const procTable *t, int running, simTime ran, simTime now) {
+	cfsState *cs = s;
+	long long leftmost;
+	int first;
+
+	cs->ran += ran;
+	cs->vruntime[running] += (ran << CFS_VRUNTIME_SHIFT) / cfsWeightOf(t, running);
+
+	/*Smallest virtual runtime only moves forward*/
+	leftmost = cs->vruntime[running];
+	first = rbFirst(&cs->tree);
+	if(first != -1 && cs->vruntime[first] < leftmost) {
+		leftmost = cs->vruntime[first];
+	}
+	if(leftmost > cs->minVruntime) {
+		cs->minVruntime = leftmost;
+	}
+	return cs->ran >= cs->sliceLen;
+}
+
+static void cfsFinish(void *s, const procTable *t, int index, simTime now) {
+	((cfsState *)s)->totalWeight -= cfsWeightOf(t, index);
+}
+
+static const schedPolicy cfsPolicy = {
+	"cfs", sizeof(cfsState), 0, cfsInit, cfsRelease, NULL, cfsEnqueue, cfsPreempt, cfsRequeue, cfsPick,
+	cfsSlice, cfsRan, cfsFinish, NULL
+};
+
+POLICY_RUNNER(runCfs, cfsPolicy)
+
+/**
+ * Function Name: 	simulateCfs
+ * Function:		Runs Completely Fair Scheduler over the process table using discrete events. Ready processes sit
+ * 					in a red-black tree keyed on virtual runtime, which grows with CPU time divided by weight; the
+ * 					leftmost one runs next. A process runs for its weighted share of the period (latency, or
+ * 					minGranularity per process when there are more), then goes back into the tree. Arrivals start at
+ * 					the smallest virtual runtime seen so far and preempt the running process if it is ahead of them
+ * 					by more than minGranularity.
+ * Input:			Process table sorted by arrivalTime, latency and minimum granularity, ticks per context switch,
+ * 					callback for every run of the CPU and its argument, counters to fill (NULL for none)
+ * Output:			Time at which last process finished, -1 if out of memory or parameters are invalid
+ * Affects:			burstTime (becomes zero), startTime, finishTime, waitingTime, IsActiveFor of every process, counters
+ * NOTES:			Every decision is O(log n) in the number of ready processes.
+ */
+
+simTime simulateCfs(procTable *t, const cfsParams *cp, simTime switchCost, runCallback onRun, void *arg,
+		engineCounters *counters) {
+	return runCfs(t, cp, switchCost, NULL, -1, onRun, arg, counters);
+}
+
+/**
+ * Function Name: 	simulatePolicy
+ * Function:		Runs a policy given at run time over the process table using discrete events
+ * Input:			Process table sorted by arrivalTime, policy, parameters handed to its init, ticks per context
+ * 					switch, callback for every run of the CPU and its argument, counters to fill (NULL for none)
+ * Output:			Time at which last process finished, -1 if a required hook is missing, init failed, out of
+ * 					memory, a slice was negative or the policy lost a process
+ * Affects:			burstTime (becomes zero), startTime, finishTime, waitingTime, IsActiveFor of every process, counters
+ * NOTES:			Same loop as the built-in algorithms, calling hooks through the table.
+ */
+
+simTime simulatePolicy(procTable *t, const schedPolicy *p, const void *params, simTime switchCost, runCallback onRun,
+		void *arg, engineCounters *counters) {
+	if(p->enqueue == NULL || p->onPreempt == NULL || p->pickNext == NULL || p->slice == NULL) {
+		return -1;
+	}
+	return runPolicy(t, p, params, switchCost, NULL, -1, onRun, arg, counters);
+}
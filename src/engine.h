@@ -0,0 +1,73 @@
+/*
+ ============================================================================
+ Name        : engine.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Discrete event simulation core shared by all scheduling
+               algorithms. Time jumps straight from one scheduling decision
+               (arrival, completion, quantum expiry) to the next one.
+               Switching the CPU from one process to another may cost a
+               fixed number of ticks, during which no process progresses.
+               Algorithms are policies of one event loop, see policy.h.
+ ============================================================================
+ */
+
+#ifndef ENGINE_H_
+#define ENGINE_H_
+
+#include "proctable.h"
+#include "checkpoint.h"
+#include "counters.h"
+#include "policy.h"
+
+/* Algorithms understood by simulate(), later ones have a simulate function of their own */
+enum {
+	ALGO_FCFS = 1,			/* First Come First Serve */
+	ALGO_SJFP,				/* Shortest Job First (Preemptive) */
+	ALGO_PRIORITY,			/* Priority Based (Non-Preemptive), process table already sorted by prioSort */
+	ALGO_RR,				/* Round Robin */
+	ALGO_PRIORITY_PREEMPTIVE,	/* Priority Based (Preemptive) on priority column, with optional aging */
+	ALGO_MLFQ,				/* Multilevel Feedback Queue */
+	ALGO_CFS,				/* Completely Fair Scheduler, weighted by priority column */
+	ALGO_POLICY				/* schedPolicy given at run time, see simulatePolicy() */
+};
+
+#define ALGO_LAST ALGO_POLICY	/* Highest algorithm number */
+
+#define IDLE_PROCESS -1			/* Process index reported while CPU is idle */
+#define SWITCHING_PROCESS -3	/* Process index reported while CPU pays context switch cost */
+#define MLFQ_MAX_LEVELS 16
+
+/* Multilevel Feedback Queue. Level 0 is the highest one */
+typedef struct {
+	int levels;
+	simTime quantum[MLFQ_MAX_LEVELS];	/* Time a process may use at a level before it is demoted */
+	simTime boostInterval;		/* Every so many ticks all processes go back to level 0, 0 = never */
+}mlfqParams;
+
+/* Completely Fair Scheduler, as in Linux */
+typedef struct {
+	simTime latency;			/* Period in which every runnable process should run once */
+	simTime minGranularity;		/* Shortest slice, period grows past latency to give each process this much */
+}cfsParams;
+
+/*
+ * Called once for every stretch of time the CPU spends on one process.
+ * Arguments are process table, index of process (IDLE_PROCESS when CPU is idle, SWITCHING_PROCESS while it
+ * switches), start time, length.
+ */
+typedef void (*runCallback)(const procTable *, int, simTime, simTime, void *);
+
+simTime simulate(procTable *, int, simTime, runCallback, void *);	/* Runs the algorithm and returns the finish time of last process */
+simTime simulateFrom(procTable *, int, simTime, simTime, checkpointLog *, int, runCallback, void *, engineCounters *);
+								/* As simulate() with given switch cost, taking checkpoints in log or resuming from
+								   given one (-1 = none), and filling counters (may be NULL) */
+simTime simulatePriority(procTable *, simTime, simTime, runCallback, void *, engineCounters *);	/* Preemptive Priority with given aging
+																								   interval (0 = none) and switch cost */
+simTime simulateMlfq(procTable *, const mlfqParams *, simTime, runCallback, void *, engineCounters *);	/* Multilevel Feedback Queue */
+simTime simulateCfs(procTable *, const cfsParams *, simTime, runCallback, void *, engineCounters *);	/* Completely Fair Scheduler */
+simTime simulatePolicy(procTable *, const schedPolicy *, const void *, simTime, runCallback, void *, engineCounters *);
+								/* Policy, parameters handed to its init, switch cost, callback, argument, counters.
+								   Hooks are called through the table */
+
+#endif /* ENGINE_H_ */
@@ -0,0 +1,115 @@
+/*
+ ============================================================================
+ Name        : heap.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Indexed binary min-heap. Every operation is O(log n).
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include "heap.h"
+
+/* Tells whether process a should be above process b */
+static int before(const minHeap *h, int a, int b) {
+	return h->key[a] < h->key[b] || (h->key[a] == h->key[b] && a < b);
+}
+
+static void place(minHeap *h, int i, int index) {
+	h->slot[i] = index;
+	h->pos[index] = i;
+}
+
+static void siftUp(minHeap *h, int i) {
+	int index = h->slot[i], parent;
+
+	while(i > 0) {
+		parent = (i - 1) / 2;
+		if(!before(h, index, h->slot[parent])) {
+			break;
+		}
+		place(h, i, h->slot[parent]);
+		i = parent;
+	}
+	place(h, i, index);
+}
+
+static void siftDown(minHeap *h, int i) {
+	int index = h->slot[i], child;
+
+	while((child = 2 * i + 1) < h->count) {
+		if(child + 1 < h->count && before(h, h->slot[child + 1], h->slot[child])) {
+			child++;
+		}
+		if(!before(h, h->slot[child], index)) {
+			break;
+		}
+		place(h, i, h->slot[child]);
+		i = child;
+	}
+	place(h, i, index);
+}
+
+/**
+ * Function Name: 	heapInit
+ * Function:		Allocates an empty heap able to hold process indices 0..capacity-1
+ * Input:			Heap, capacity
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Heap
+ */
+
+int heapInit(minHeap *h, int capacity) {
+	int i;
+
+	if(capacity < 1) {
+		capacity = 1;
+	}
+	h->key = malloc(capacity * (sizeof(long long) + 2 * sizeof(int)));	/*One allocation for all three arrays*/
+	if(h->key == NULL) {
+		return -1;
+	}
+	h->slot = (int *)(h->key + capacity);
+	h->pos = h->slot + capacity;
+	h->count = 0;
+	h->capacity = capacity;
+	for(i=0; i<capacity; i++) {
+		h->pos[i] = -1;
+	}
+	return 0;
+}
+
+void heapFree(minHeap *h) {
+	free(h->key);
+	h->key = NULL;
+	h->slot = h->pos = NULL;
+	h->count = 0;
+}
+
+void heapPush(minHeap *h, int index, long long key) {
+	h->key[index] = key;
+	h->slot[h->count] = index;
+	h->pos[index] = h->count;
+	h->count++;
+	siftUp(h, h->count - 1);
+}
+
+int heapTop(const minHeap *h) {
+	return h->slot[0];
+}
+
+int heapPop(minHeap *h) {
+	int index = h->slot[0];
+
+	h->pos[index] = -1;
+	h->count--;
+	if(h->count > 0) {
+		h->slot[0] = h->slot[h->count];
+		siftDown(h, 0);
+	}
+	return index;
+}
+
+void heapDecreaseKey(minHeap *h, int index, long long key) {
+	h->key[index] = key;
+	siftUp(h, h->pos[index]);
+}
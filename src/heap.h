@@ -0,0 +1,30 @@
+/*
+ ============================================================================
+ Name        : heap.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Indexed binary min-heap of process indices. Used as ready queue
+               of Shortest Job First, keyed on remaining burst time. Ties are
+               broken by process index, i.e. by arrival order.
+ ============================================================================
+ */
+
+#ifndef HEAP_H_
+#define HEAP_H_
+
+typedef struct {
+	int *slot;			/* Heap ordered process indices */
+	int *pos;			/* Position of every process inside slot, -1 if not in heap */
+	long long *key;		/* Key of every process */
+	int count;
+	int capacity;
+}minHeap;
+
+int heapInit(minHeap *, int);				/* Allocates heap for given number of processes, returns 0 on success */
+void heapFree(minHeap *);
+void heapPush(minHeap *, int, long long);			/* Inserts process index with key */
+int heapTop(const minHeap *);				/* Index of process having smallest key */
+int heapPop(minHeap *);						/* Removes and returns index of process having smallest key */
+void heapDecreaseKey(minHeap *, int, long long);	/* Lowers key of a process already in heap */
+
+#endif /* HEAP_H_ */
@@ -0,0 +1,559 @@
+/*
+ ============================================================================
+ Name        : output.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Buffered report writer, see output.h
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "output.h"
+
+/* Header row of every section in text and CSV format, indexed by format then section */
+static const char *sectionHeader[2][6] = {
+	{ "", "CPU\tStart\tLength\tPName\n", "PName\tArrTime\tPriority\tBTime\tSTime\tFTime\tWTime\tTATime\n", "",
+			"Metric\t\tMean\tMedian\tP95\tP99\tMax\n", "" },
+	{ "", "cpu,start,length,index,process\n", "name,arrival,priority,burst,start,finish,waiting,turnaround\n",
+			"processes,total_time,avg_waiting,avg_turnaround,switches,throughput,utilization,cpus,migrations,steals\n",
+			"metric,mean,median,p95,p99,max\n", "switch_cost,preemptions,idle_time,switch_time,avg_queue,max_queue\n" }
+};
+static const char *sectionKey[6] = { "", "segments", "processes", "summary", "metrics", "counters" };
+
+/* Writes all of data, retrying short writes. First failure is reported, later ones are not */
+static void writeAll(outStream *out, const char *data, size_t len) {
+	size_t done = 0;
+	ssize_t n;
+
+	while(done < len && !out->failed) {
+		n = write(out->fd, data + done, len - done);
+		if(n < 0 && errno == EINTR) {
+			continue;
+		}
+		if(n <= 0) {
+			perror("Writing report");
+			out->failed = 1;
+		} else {
+			done += n;
+		}
+	}
+}
+
+static void flush(outStream *out) {
+	writeAll(out, out->buf, out->used);
+	out->used = 0;
+}
+
+void outWrite(outStream *out, const void *data, size_t len) {
+	if(len > OUT_BUFFER_SIZE - out->used) {
+		flush(out);
+		if(len > OUT_BUFFER_SIZE) {
+			writeAll(out, data, len);	/*Bigger than the whole buffer, no use copying it*/
+			return;
+		}
+	}
+	memcpy(out->buf + out->used, data, len);
+	out->used += len;
+}
+
+static void putChar(outStream *out, char c) {
+	if(out->used == OUT_BUFFER_SIZE) {
+		flush(out);
+	}
+	out->buf[out->used++] = c;
+}
+
+static void putStr(outStream *out, const char *s) {
+	outWrite(out, s, strlen(s));
+}
+
+/* Decimal digits without going through printf, the per-record paths print little else */
+static void putInt(outStream *out, long long v) {
+	char digits[24], *p = digits + sizeof(digits);
+	unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+
+	do {
+		*--p = (char)('0' + u % 10);
+		u /= 10;
+	} while(u);
+	if(v < 0) {
+		*--p = '-';
+	}
+	outWrite(out, p, digits + sizeof(digits) - p);
+}
+
+/* Field separator of the format, preceding every field but the first of a row */
+static void putSep(outStream *out) {
+	putChar(out, out->format == OUT_TEXT ? '\t' : ',');
+}
+
+/* JSON key of a field with its separator */
+static void putKey(outStream *out, const char *key, int first) {
+	if(!first) {
+		putChar(out, ',');
+	}
+	putChar(out, '"');
+	putStr(out, key);
+	putStr(out, "\":");
+}
+
+/* One integer field of a row (text, CSV) or object (JSON) */
+static void putField(outStream *out, const char *key, long long v, int first) {
+	if(out->format == OUT_JSON) {
+		putKey(out, key, first);
+	} else if(!first) {
+		putSep(out);
+	}
+	putInt(out, v);
+}
+
+/* Name quoted as the format needs: JSON string, CSV field quoted only when it has to be, text as it is */
+static void putName(outStream *out, const char *name) {
+	static const char hex[] = "0123456789abcdef";
+	const char *c;
+
+	if(out->format == OUT_JSON) {
+		putChar(out, '"');
+		for(c=name; *c; c++) {
+			if(*c == '"' || *c == '\\') {
+				putChar(out, '\\');
+				putChar(out, *c);
+			} else if((unsigned char)*c < 0x20) {
+				putStr(out, "\\u00");
+				putChar(out, hex[(unsigned char)*c >> 4]);
+				putChar(out, hex[*c & 15]);
+			} else {
+				putChar(out, *c);
+			}
+		}
+		putChar(out, '"');
+	} else if(out->format == OUT_CSV && strpbrk(name, ",\"\r\n")) {
+		putChar(out, '"');
+		for(c=name; *c; c++) {
+			if(*c == '"') {
+				putChar(out, '"');
+			}
+			putChar(out, *c);
+		}
+		putChar(out, '"');
+	} else {
+		putStr(out, name);
+	}
+}
+
+void outPrintf(outStream *out, const char *fmt, ...) {
+	va_list ap;
+	int len;
+
+	va_start(ap, fmt);
+	len = vsnprintf(out->buf + out->used, OUT_BUFFER_SIZE - out->used, fmt, ap);
+	va_end(ap);
+	if(len >= 0 && (size_t)len >= OUT_BUFFER_SIZE - out->used) {
+		/*Did not fit, vsnprintf() wrote nothing usable. Again at start of an empty buffer*/
+		flush(out);
+		va_start(ap, fmt);
+		len = vsnprintf(out->buf, OUT_BUFFER_SIZE, fmt, ap);
+		va_end(ap);
+	}
+	if(len < 0 || (size_t)len >= OUT_BUFFER_SIZE - out->used) {
+		out->failed = 1;
+		return;
+	}
+	out->used += len;
+}
+
+static void flushSegments(outStream *out);
+
+static void endSection(outStream *out) {
+	if(out->format == OUT_JSON && out->section != OUT_NONE && out->section != OUT_SUMMARY && out->section != OUT_COUNTERS) {
+		putChar(out, ']');
+	}
+}
+
+/* Starts a section unless it is the one being written: header row, or key of JSON array */
+static void beginSection(outStream *out, int section) {
+	if(out->section == section) {
+		return;
+	}
+	if(section != OUT_SEGMENTS) {
+		flushSegments(out);
+	}
+	endSection(out);
+	if(out->format == OUT_JSON) {
+		if(out->section != OUT_NONE) {
+			putChar(out, ',');
+		}
+		putChar(out, '"');
+		putStr(out, sectionKey[section]);
+		putStr(out, section == OUT_SUMMARY || section == OUT_COUNTERS ? "\":" : "\":[");
+	} else if(out->format != OUT_BINARY) {
+		if(out->section != OUT_NONE) {
+			putChar(out, '\n');
+		}
+		putStr(out, sectionHeader[out->format][section]);
+	}
+	out->section = section;
+	out->count = 0;
+}
+
+/* Starts a record of current section: comma and brace of JSON */
+static void beginRecord(outStream *out) {
+	if(out->format == OUT_JSON) {
+		if(out->count > 0) {
+			putChar(out, ',');
+		}
+		putChar(out, '{');
+	}
+	out->count++;
+}
+
+static void endRecord(outStream *out) {
+	putChar(out, out->format == OUT_JSON ? '}' : '\n');
+}
+
+/**
+ * Function Name: 	outOpen
+ * Function:		Opens a report and starts it (JSON brace, binary magic)
+ * Input:			Report to initialise, path ("-" is standard output), format, verbosity
+ * Output:			0 on success, -1 if file cannot be created or out of memory (message printed)
+ * Affects:			File at path, which is truncated
+ */
+
+int outOpen(outStream *out, const char *path, int format, int verbosity) {
+	memset(out, 0, sizeof(*out));
+	out->format = format;
+	out->verbosity = verbosity;
+	out->section = OUT_NONE;
+	out->fd = strcmp(path, "-") == 0 ? STDOUT_FILENO : open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(out->fd < 0) {
+		perror(path);
+		return -1;
+	}
+	out->buf = malloc(OUT_BUFFER_SIZE);
+	if(out->buf == NULL) {
+		fprintf(stderr, "Not enough memory for output buffer\n");
+		if(out->fd != STDOUT_FILENO) {
+			close(out->fd);
+		}
+		return -1;
+	}
+	if(format == OUT_JSON) {
+		putChar(out, '{');
+	} else if(format == OUT_BINARY) {
+		outWrite(out, OUT_MAGIC, 8);
+	}
+	return 0;
+}
+
+int outClose(outStream *out) {
+	flushSegments(out);
+	free(out->pending);
+	out->pending = NULL;
+	endSection(out);
+	if(out->format == OUT_JSON) {
+		putStr(out, "}\n");
+	}
+	flush(out);
+	free(out->buf);
+	out->buf = NULL;
+	if(out->fd != STDOUT_FILENO && close(out->fd) != 0 && !out->failed) {
+		perror("Writing report");
+		out->failed = 1;
+	}
+	return out->failed ? -1 : 0;
+}
+
+/* Writes one segment record */
+static void writeSegment(outStream *out, int cpu, int running, const procTable *t, simTime start, simTime length) {
+	outRecord rec;
+
+	beginSection(out, OUT_SEGMENTS);
+	if(out->format == OUT_BINARY) {
+		memset(&rec, 0, sizeof(rec));
+		rec.type = OUT_SEGMENTS;
+		rec.value[0] = cpu;
+		rec.value[1] = running;
+		rec.value[2] = start;
+		rec.value[3] = length;
+		outWrite(out, &rec, sizeof(rec));
+		return;
+	}
+	beginRecord(out);
+	putField(out, "cpu", cpu, 1);
+	putField(out, "start", start, 0);
+	putField(out, "length", length, 0);
+	if(out->format == OUT_TEXT) {
+		putSep(out);
+		putStr(out, running >= 0 ? PROC_NAME(t, running) : running == IDLE_PROCESS ? "idle" :
+				running == SWITCHING_PROCESS ? "switching" : "migrating");
+	} else {
+		putField(out, "index", running, 0);
+		if(out->format == OUT_JSON) {
+			putKey(out, "process", 0);
+		} else {
+			putSep(out);
+		}
+		if(running >= 0) {
+			putName(out, PROC_NAME(t, running));
+		} else if(out->format == OUT_JSON) {
+			putStr(out, "null");
+		}
+	}
+	endRecord(out);
+}
+
+/* Writes the run every CPU still holds back */
+static void flushSegments(outStream *out) {
+	int c;
+
+	for(c=0; c<out->numPending; c++) {
+		if(out->pending[c].length > 0) {
+			writeSegment(out, c, out->pending[c].process, out->runTable, out->pending[c].start, out->pending[c].length);
+			out->pending[c].length = 0;
+		}
+	}
+}
+
+/**
+ * Function Name: 	outSegment
+ * Function:		Writes one run of a CPU, for onRun and onCpuRun callbacks at VERBOSITY_EVENTS. A run is held
+ * 					back till the next one of its CPU, which is merged into it when it continues the same
+ * 					process, so every segment is one contiguous run as in the Gantt chart
+ * Input:			Report, CPU, process (IDLE_PROCESS or MIGRATING_PROCESS), table of the run, start time, length
+ * Output:			None
+ * Affects:			Report
+ * NOTES:			Empty runs are left out. Runs held back are written when another section starts or the
+ * 					report is closed. If there is no memory to hold runs back they are written as they come.
+ */
+
+void outSegment(outStream *out, int cpu, int running, const procTable *t, simTime start, simTime length) {
+	segment *last, *grown;
+
+	if(length <= 0) {
+		return;
+	}
+	if(cpu >= out->numPending) {
+		grown = realloc(out->pending, (cpu + 1) * sizeof(segment));
+		if(grown == NULL) {
+			writeSegment(out, cpu, running, t, start, length);
+			return;
+		}
+		memset(grown + out->numPending, 0, (cpu + 1 - out->numPending) * sizeof(segment));
+		out->pending = grown;
+		out->numPending = cpu + 1;
+	}
+	last = &out->pending[cpu];
+	if(last->length > 0 && last->process == running && last->start + last->length == start) {
+		last->length += length;
+		return;
+	}
+	if(last->length > 0) {
+		writeSegment(out, cpu, last->process, out->runTable, last->start, last->length);
+	}
+	out->runTable = t;
+	last->process = running;
+	last->start = start;
+	last->length = length;
+}
+
+/**
+ * Function Name: 	outProcesses
+ * Function:		Writes final table of a run, one record per process in scheduling order
+ * Input:			Report, executed table, flag telling arrivalTime holds priority (every process arrived at 0)
+ * Output:			None
+ * Affects:			Report
+ */
+
+void outProcesses(outStream *out, const procTable *t, int arrivalIsPriority) {
+	outRecord rec;
+	simTime arrival;
+	const char *name;
+	int i;
+
+	beginSection(out, OUT_PROCESSES);
+	memset(&rec, 0, sizeof(rec));
+	rec.type = OUT_PROCESSES;
+	for(i=0; i<t->numOfProcesses; i++) {
+		arrival = arrivalIsPriority ? 0 : t->arrivalTime[i];
+		name = PROC_NAME(t, i);
+		if(out->format == OUT_BINARY) {
+			rec.nameLength = (uint32_t)strlen(name);
+			rec.value[0] = arrival;
+			rec.value[1] = t->IsActiveFor[i];
+			rec.value[2] = t->priority[i];
+			rec.value[3] = t->startTime[i];
+			rec.value[4] = t->finishTime[i];
+			rec.value[5] = t->waitingTime[i];
+			outWrite(out, &rec, sizeof(rec));
+			outWrite(out, name, rec.nameLength);
+			continue;
+		}
+		beginRecord(out);
+		if(out->format == OUT_JSON) {
+			putKey(out, "name", 1);
+		}
+		putName(out, name);
+		putField(out, "arrival", arrival, 0);
+		putField(out, "priority", t->priority[i], 0);
+		putField(out, "burst", t->IsActiveFor[i], 0);
+		putField(out, "start", t->startTime[i], 0);
+		putField(out, "finish", t->finishTime[i], 0);
+		putField(out, "waiting", t->waitingTime[i], 0);
+		putField(out, "turnaround", t->finishTime[i] - arrival, 0);
+		endRecord(out);
+	}
+}
+
+/* One percentile row of the metrics section */
+static void outMetric(outStream *out, int metric, const metricSummary *m) {
+	static const char *label[] = { "Ready wait", "Turnaround", "Response", "I/O wait" };
+	static const char *key[] = { "ready_wait", "turnaround", "response", "io_wait" };
+	outRecord rec;
+
+	if(out->format == OUT_BINARY) {
+		memset(&rec, 0, sizeof(rec));
+		rec.type = OUT_METRICS;
+		rec.value[0] = metric;
+		rec.value[1] = m->median;
+		rec.value[2] = m->p95;
+		rec.value[3] = m->p99;
+		rec.value[4] = m->max;
+		rec.real[0] = m->mean;
+		outWrite(out, &rec, sizeof(rec));
+	} else if(out->format == OUT_JSON) {
+		beginRecord(out);
+		outPrintf(out, "\"metric\":\"%s\",\"mean\":%.2f", key[metric], m->mean);
+		putField(out, "median", m->median, 0);
+		putField(out, "p95", m->p95, 0);
+		putField(out, "p99", m->p99, 0);
+		putField(out, "max", m->max, 0);
+		endRecord(out);
+	} else {
+		outPrintf(out, out->format == OUT_TEXT ? "%-10s\t%.2f\t%lld\t%lld\t%lld\t%lld\n" : "%s,%.2f,%lld,%lld,%lld,%lld\n",
+				out->format == OUT_TEXT ? label[metric] : key[metric], m->mean, m->median, m->p95, m->p99, m->max);
+	}
+}
+
+/**
+ * Function Name: 	outSummary
+ * Function:		Writes totals and averages of a run followed by percentiles of its statistics
+ * Input:			Report, run, statistics computed on its table, number of CPUs
+ * Output:			None
+ * Affects:			Report
+ * NOTES:			Average waiting is time till first run (WTime of final table) as everywhere else, utilization
+ * 					is mean of all CPUs. I/O wait is only written for workloads with I/O bursts.
+ */
+
+void outSummary(outStream *out, const schedResult *run, const runStats *st, int numCpus) {
+	int n = run->table.numOfProcesses;
+	double utilization = st->utilization / numCpus;
+	outRecord rec;
+
+	beginSection(out, OUT_SUMMARY);
+	if(out->format == OUT_BINARY) {
+		memset(&rec, 0, sizeof(rec));
+		rec.type = OUT_SUMMARY;
+		rec.value[0] = n;
+		rec.value[1] = run->totalTime;
+		rec.value[2] = run->contextSwitches;
+		rec.value[3] = numCpus;
+		rec.value[4] = run->migrations;
+		rec.value[5] = run->steals;
+		rec.real[0] = st->response.mean;
+		rec.real[1] = st->turnaround.mean;
+		rec.real[2] = st->throughput;
+		rec.real[3] = utilization;
+		outWrite(out, &rec, sizeof(rec));
+	} else if(out->format == OUT_JSON) {
+		outPrintf(out, "{\"processes\":%d,\"total_time\":%lld,\"avg_waiting\":%.2f,\"avg_turnaround\":%.2f,"
+				"\"switches\":%lld,\"throughput\":%.4f,\"utilization\":%.4f,\"cpus\":%d,\"migrations\":%lld,\"steals\":%lld}",
+				n, run->totalTime, st->response.mean, st->turnaround.mean, run->contextSwitches, st->throughput,
+				utilization, numCpus, run->migrations, run->steals);
+	} else if(out->format == OUT_CSV) {
+		outPrintf(out, "%d,%lld,%.2f,%.2f,%lld,%.4f,%.4f,%d,%lld,%lld\n", n, run->totalTime, st->response.mean,
+				st->turnaround.mean, run->contextSwitches, st->throughput, utilization, numCpus, run->migrations,
+				run->steals);
+	} else {
+		outPrintf(out, "Processes: %d\nTotal Time: %lld\nAverage Waiting Time: %.2f\nAverage Turnaround Time: %.2f\n"
+				"Context Switches: %lld\nThroughput: %.4f processes per unit time\nCPU Utilization: %.2f%%\n",
+				n, run->totalTime, st->response.mean, st->turnaround.mean, run->contextSwitches, st->throughput,
+				utilization * 100);
+		if(numCpus > 1) {
+			outPrintf(out, "CPUs: %d, Migrations: %lld, Steals: %lld\n", numCpus, run->migrations, run->steals);
+		}
+	}
+
+	beginSection(out, OUT_METRICS);
+	outMetric(out, 0, &st->waiting);
+	outMetric(out, 1, &st->turnaround);
+	outMetric(out, 2, &st->response);
+	if(run->table.ioTime) {
+		outMetric(out, 3, &st->ioWait);
+	}
+}
+
+/**
+ * Function Name: 	outCounters
+ * Function:		Writes counters of a run kept by the engine
+ * Input:			Report, run, ticks per context switch it was run with
+ * Output:			None
+ * Affects:			Report
+ */
+
+void outCounters(outStream *out, const schedResult *run, simTime switchCost) {
+	outRecord rec;
+
+	beginSection(out, OUT_COUNTERS);
+	if(out->format == OUT_BINARY) {
+		memset(&rec, 0, sizeof(rec));
+		rec.type = OUT_COUNTERS;
+		rec.value[0] = switchCost;
+		rec.value[1] = run->preemptions;
+		rec.value[2] = run->idleTime;
+		rec.value[3] = run->switchTime;
+		rec.value[4] = run->maxQueue;
+		rec.real[0] = run->avgQueue;
+		outWrite(out, &rec, sizeof(rec));
+	} else if(out->format == OUT_JSON) {
+		outPrintf(out, "{\"switch_cost\":%lld,\"preemptions\":%lld,\"idle_time\":%lld,\"switch_time\":%lld,"
+				"\"avg_queue\":%.2f,\"max_queue\":%d}", switchCost, run->preemptions, run->idleTime, run->switchTime,
+				run->avgQueue, run->maxQueue);
+	} else if(out->format == OUT_CSV) {
+		outPrintf(out, "%lld,%lld,%lld,%lld,%.2f,%d\n", switchCost, run->preemptions, run->idleTime, run->switchTime,
+				run->avgQueue, run->maxQueue);
+	} else {
+		outPrintf(out, "Switch Cost: %lld\nPreemptions: %lld\nIdle Time: %lld\nSwitch Time: %lld\n"
+				"Ready Queue: %.2f mean, %d max\n", switchCost, run->preemptions, run->idleTime, run->switchTime,
+				run->avgQueue, run->maxQueue);
+	}
+}
+
+int parseFormat(const char *arg) {
+	static const char *name[] = { "text", "csv", "json", "binary" };
+	int i;
+
+	for(i=OUT_TEXT; i<=OUT_BINARY; i++) {
+		if(strcmp(arg, name[i]) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int parseVerbosity(const char *arg) {
+	static const char *name[] = { "quiet", "summary", "processes", "events" };
+	int i;
+
+	for(i=VERBOSITY_QUIET; i<=VERBOSITY_EVENTS; i++) {
+		if(strcmp(arg, name[i]) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,87 @@
+/*
+ ============================================================================
+ Name        : output.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Buffered report writer for batch runs. Records go into one
+               large buffer that is handed to write(2) only when full or
+               at close, so a run with millions of Gantt segments costs a
+               few system calls instead of one printf per row. Numbers are
+               formatted by hand on the per-record paths.
+               A report holds up to five sections, each one only when the
+               verbosity asks for it:
+                   segments   every run of every CPU (VERBOSITY_EVENTS)
+                   processes  final table (VERBOSITY_PROCESSES and above)
+                   summary    totals and averages (VERBOSITY_SUMMARY and
+                              above)
+                   metrics    percentiles of ready wait, turnaround and
+                              response time, and I/O wait of workloads
+                              with I/O bursts (same)
+                   counters   preemptions, idle and switch time, ready
+                              queue length (same)
+               Formats: text (tab separated, one header per section), CSV
+               (one header row per section, sections separated by an empty
+               line), JSON (one object with an array per section, summary
+               an object) and binary: OUT_MAGIC followed by outRecords,
+               each process record followed by nameLength bytes of name.
+               Segments refer to processes by their index among process
+               records, -1 idle, -2 migrating and -3 switching.
+ ============================================================================
+ */
+
+#ifndef OUTPUT_H_
+#define OUTPUT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sched.h"
+#include "stats.h"
+#include "timeline.h"
+
+#define OUT_BUFFER_SIZE (1 << 20)
+#define OUT_MAGIC "SCHEDOU1"
+
+enum { OUT_TEXT, OUT_CSV, OUT_JSON, OUT_BINARY };
+enum { VERBOSITY_QUIET, VERBOSITY_SUMMARY, VERBOSITY_PROCESSES, VERBOSITY_EVENTS };
+enum { OUT_NONE, OUT_SEGMENTS, OUT_PROCESSES, OUT_SUMMARY, OUT_METRICS, OUT_COUNTERS };
+
+typedef struct {
+	uint32_t type;				/* OUT_SEGMENTS .. OUT_COUNTERS */
+	uint32_t nameLength;		/* Bytes of name following a process record, 0 otherwise */
+	int64_t value[6];			/* Segment:  cpu, process, start, length
+								   Process:  arrival, burst, priority, start, finish, waiting
+								   Summary:  processes, total time, switches, CPUs, migrations, steals
+								   Metric:   metric (0 ready wait, 1 turnaround, 2 response, 3 I/O wait), median, p95, p99,
+											 max
+								   Counters: switch cost, preemptions, idle time, switch time, longest ready queue */
+	double real[4];				/* Summary:  average waiting, average turnaround, throughput, utilization
+								   Metric:   mean
+								   Counters: mean ready queue */
+}outRecord;
+
+typedef struct {
+	int fd;
+	int format;
+	int verbosity;
+	char *buf;
+	size_t used;
+	int failed;					/* A write failed, reported by outClose() */
+	int section;				/* Section being written */
+	long long count;			/* Records written in it */
+	segment *pending;			/* Last run of every CPU not written yet, so contiguous runs are merged */
+	int numPending;				/* CPUs in pending */
+	const procTable *runTable;	/* Table the pending runs belong to */
+}outStream;
+
+int outOpen(outStream *, const char *, int, int);	/* Path ("-" is stdout), format, verbosity. 0 on success, -1 on error */
+int outClose(outStream *);							/* Ends report and flushes it. 0 on success, -1 if a write failed */
+void outWrite(outStream *, const void *, size_t);
+void outPrintf(outStream *, const char *, ...);
+void outSegment(outStream *, int, int, const procTable *, simTime, simTime);	/* CPU, process, table, start, length */
+void outProcesses(outStream *, const procTable *, int);	/* Table, flag telling arrivalTime holds priority */
+void outSummary(outStream *, const schedResult *, const runStats *, int);	/* Run, its statistics, CPUs */
+void outCounters(outStream *, const schedResult *, simTime);	/* Run, ticks per context switch */
+int parseFormat(const char *);						/* "text", "csv", "json", "binary", -1 if unknown */
+int parseVerbosity(const char *);					/* "quiet", "summary", "processes", "events", -1 if unknown */
+
+#endif /* OUTPUT_H_ */
@@ -0,0 +1,76 @@
+/*
+ ============================================================================
+ Name        : policy.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Scheduling policy interface of the discrete event engine. The
+               engine owns the clock, arrivals, context switches, counters
+               and the process table; a policy only keeps its ready set and
+               decides who runs and for how long, through the hooks below.
+               Every built-in algorithm is such a policy. The engine loop is
+               inlined into one copy per built-in policy with its hooks
+               known at compile time, so those copies make no indirect
+               calls. Other policies go through the same loop calling hooks
+               by pointer, see simulatePolicy() in engine.h.
+
+               A run calls, at every scheduling decision:
+                   tick       clock reached now, before arrivals join
+                   enqueue    for each process that has arrived by now
+                   onPreempt  for the process whose slice expired at now,
+                              after the arrivals, so they get in line first
+                   preempt    while a process holds the CPU: should it give
+                              it up? If so onPreempt puts it back
+                   pickNext   when the CPU is free: take next process off
+                              the ready set
+                   slice      how long it may run before the next decision
+                              (the engine cuts nothing itself); 0 gives the
+                              CPU back at once unless the process is done
+                   ran        after it ran: non-zero if its slice expired
+                   finish     its CPU burst is over: it completed or it
+                              blocks on I/O
+                   wake       for each process whose I/O is over by now,
+                              in time order with the arrivals
+               A policy without preempt never takes the CPU away early, so
+               it keeps its pick even when a context switch let time pass.
+               A policy without wake gets woken processes through enqueue.
+               The next arrival handed to slice is the next wakeup when
+               that comes first.
+               enqueue, onPreempt, pickNext and slice are required.
+
+               A policy built as a shared object for schedalgos
+               --policy-lib exports one schedPolicy named
+               POLICY_SYMBOL.
+ ============================================================================
+ */
+
+#ifndef POLICY_H_
+#define POLICY_H_
+
+#include <stddef.h>
+#include "proctable.h"
+
+#define POLICY_ARRIVE_AT_ZERO 1		/* Every process is ready at 0, arrivalTime holds something else (ALGO_PRIORITY) */
+#define POLICY_SYMBOL "schedPolicyTable"
+
+typedef struct {
+	const char *name;
+	size_t stateSize;			/* Bytes of zeroed state handed to every hook of one run */
+	int flags;					/* POLICY_* */
+	int (*init)(void *, const procTable *, const void *);	/* State, table, parameters. 0 on success, may be NULL */
+	void (*release)(void *);							/* Frees what init allocated, may be NULL */
+	void (*tick)(void *, const procTable *, simTime, int);	/* Now, process on CPU or IDLE_PROCESS. May be NULL */
+	void (*enqueue)(void *, const procTable *, int, simTime);	/* Process, now */
+	int (*preempt)(void *, const procTable *, int, int, simTime);	/* Running process, flag telling a process arrived
+																	   at now, now. May be NULL */
+	void (*onPreempt)(void *, const procTable *, int, int, simTime);	/* Process, flag telling its slice expired (else
+																		   it was preempted), now */
+	int (*pickNext)(void *, const procTable *, simTime);	/* Now. Process, -1 if nothing is ready */
+	simTime (*slice)(void *, const procTable *, int, simTime, simTime);	/* Process, now, next arrival (-1 if none) */
+	int (*ran)(void *, const procTable *, int, simTime, simTime);	/* Process, ticks it ran, now (after them). May be NULL */
+	void (*finish)(void *, const procTable *, int, simTime);	/* Process, now. May be NULL */
+	int (*ready)(const void *, int);	/* i-th process of ready set in an order enqueue() rebuilds it from, -1 past
+										   the end. Needed for checkpoints only, may be NULL */
+	void (*wake)(void *, const procTable *, int, simTime);	/* Process, time its I/O ended (now or before). May be NULL */
+}schedPolicy;
+
+#endif /* POLICY_H_ */
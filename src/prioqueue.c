@@ -0,0 +1,235 @@
+/*
+ ============================================================================
+ Name        : prioqueue.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Bitmap indexed bucket queue with aging, see prioqueue.h.
+               Levels below the top one live in a ring of FIFOs: slot of a
+               level moves down by one with every aging step, so after a
+               step the slot that held the level just below the top holds
+               the lowest level and its FIFO is appended to the top one.
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include "prioqueue.h"
+
+/* Bits 0..b of a word */
+static unsigned long long upTo(int b) {
+	return b == 63 ? ~0ULL : (2ULL << b) - 1;
+}
+
+static int highestBit(unsigned long long word) {
+	return 63 - __builtin_clzll(word);
+}
+
+static void setBit(prioQueue *q, int slot) {
+	int d;
+
+	for(d=0; d<q->depth; d++) {
+		q->bits[d][slot >> 6] |= 1ULL << (slot & 63);
+		slot >>= 6;
+	}
+}
+
+static void clearBit(prioQueue *q, int slot) {
+	int d;
+
+	for(d=0; d<q->depth; d++) {
+		q->bits[d][slot >> 6] &= ~(1ULL << (slot & 63));
+		if(q->bits[d][slot >> 6] != 0) {
+			break;		/*Word still has other bits, levels above stay set*/
+		}
+		slot >>= 6;
+	}
+}
+
+/* Highest set bit of bitmap level d at or below pos, -1 if none */
+static int highestAtMost(const prioQueue *q, int d, int pos) {
+	unsigned long long word;
+	int w;
+
+	if(pos < 0) {
+		return -1;
+	}
+	w = pos >> 6;
+	word = q->bits[d][w] & upTo(pos & 63);
+	if(word != 0) {
+		return (w << 6) | highestBit(word);
+	}
+	if(d + 1 == q->depth) {
+		return -1;		/*Top level is a single word*/
+	}
+	w = highestAtMost(q, d + 1, w - 1);
+	return w < 0 ? -1 : (w << 6) | highestBit(q->bits[d][w]);
+}
+
+/* Ring slot of a level below the top one */
+static int slotOf(const prioQueue *q, int level) {
+	long long s = (level - q->minLevel - q->steps) % q->slots;
+
+	return (int)(s < 0 ? s + q->slots : s);
+}
+
+/* Slot holding highest level of the ring, -1 if ring is empty */
+static int highestSlot(const prioQueue *q) {
+	int slot;
+
+	if(q->slots == 0 || q->bits[q->depth - 1][0] == 0) {
+		return -1;
+	}
+	slot = highestAtMost(q, 0, slotOf(q, q->maxLevel - 1));
+	return slot >= 0 ? slot : highestAtMost(q, 0, q->slots - 1);	/*Wrapped around the ring*/
+}
+
+/**
+ * Function Name: 	prioInit
+ * Function:		Allocates an empty queue for process indices 0..capacity-1 and priorities minLevel..maxLevel
+ * Input:			Queue, capacity, lowest and highest priority
+ * Output:			0 on success, -1 if out of memory or more than PRIO_MAX_LEVELS levels
+ * Affects:			Queue
+ */
+
+int prioInit(prioQueue *q, int capacity, int minLevel, int maxLevel) {
+	int words, d, i;
+
+	q->next = q->head = q->tail = NULL;
+	for(d=0; d<PRIO_BITMAP_DEPTH; d++) {
+		q->bits[d] = NULL;
+	}
+	if((long long)maxLevel - minLevel >= PRIO_MAX_LEVELS || maxLevel < minLevel) {
+		return -1;
+	}
+	q->slots = maxLevel - minLevel;
+	q->minLevel = minLevel;
+	q->maxLevel = maxLevel;
+	q->top = q->topTail = -1;
+	q->steps = 0;
+	q->count = 0;
+	q->next = malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+	q->head = malloc((q->slots + 1) * sizeof(int));
+	q->tail = malloc((q->slots + 1) * sizeof(int));
+	if(q->next == NULL || q->head == NULL || q->tail == NULL) {
+		prioFree(q);
+		return -1;
+	}
+	for(i=0; i<q->slots; i++) {
+		q->head[i] = -1;
+	}
+
+	/*Each bitmap level has a bit per word of the one below, up to a single word*/
+	words = q->slots;
+	q->depth = 0;
+	do {
+		words = (words + 63) / 64;
+		q->bits[q->depth] = calloc(words > 0 ? words : 1, sizeof(unsigned long long));
+		if(q->bits[q->depth++] == NULL) {
+			prioFree(q);
+			return -1;
+		}
+	} while(words > 1);
+	return 0;
+}
+
+void prioFree(prioQueue *q) {
+	int d;
+
+	free(q->next);
+	free(q->head);
+	free(q->tail);
+	for(d=0; d<PRIO_BITMAP_DEPTH; d++) {
+		free(q->bits[d]);
+		q->bits[d] = NULL;
+	}
+	q->next = q->head = q->tail = NULL;
+}
+
+/* Adds process to a FIFO given by its head and tail */
+static void fifoAdd(int *next, int *head, int *tail, int index, int atHead) {
+	if(*head == -1) {
+		next[index] = -1;
+		*head = *tail = index;
+	} else if(atHead) {
+		next[index] = *head;
+		*head = index;
+	} else {
+		next[index] = -1;
+		next[*tail] = index;
+		*tail = index;
+	}
+}
+
+void prioPush(prioQueue *q, int index, int level, int atHead) {
+	int slot;
+
+	if(level >= q->maxLevel) {
+		fifoAdd(q->next, &q->top, &q->topTail, index, atHead);
+	} else {
+		slot = slotOf(q, level < q->minLevel ? q->minLevel : level);
+		if(q->head[slot] == -1) {
+			setBit(q, slot);
+		}
+		fifoAdd(q->next, &q->head[slot], &q->tail[slot], index, atHead);
+	}
+	q->count++;
+}
+
+int prioTopLevel(const prioQueue *q) {
+	int slot;
+
+	if(q->top != -1) {
+		return q->maxLevel;
+	}
+	slot = highestSlot(q);
+	return q->minLevel + (int)((slot + q->steps) % q->slots);
+}
+
+int prioPop(prioQueue *q) {
+	int slot, index;
+
+	q->count--;
+	if(q->top != -1) {
+		index = q->top;
+		q->top = q->next[index];
+		return index;
+	}
+	slot = highestSlot(q);
+	index = q->head[slot];
+	q->head[slot] = q->next[index];
+	if(q->head[slot] == -1) {
+		clearBit(q, slot);
+	}
+	return index;
+}
+
+/**
+ * Function Name: 	prioAge
+ * Function:		Does aging steps till given total. Each step raises every waiting process below the top level
+ * 					by one level, appending those reaching the top level to its FIFO. At most one step per ring
+ * 					slot does any work, later ones only count.
+ * Input:			Queue, total number of aging steps
+ * Output:			None
+ * Affects:			Queue
+ */
+
+void prioAge(prioQueue *q, long long steps) {
+	int slot;
+
+	while(q->steps < steps && highestSlot(q) >= 0) {
+		slot = slotOf(q, q->maxLevel - 1);
+		if(q->head[slot] != -1) {
+			if(q->top == -1) {
+				q->top = q->head[slot];
+			} else {
+				q->next[q->topTail] = q->head[slot];
+			}
+			q->topTail = q->tail[slot];
+			q->head[slot] = -1;
+			clearBit(q, slot);
+		}
+		q->steps++;
+	}
+	if(q->steps < steps) {
+		q->steps = steps;
+	}
+}
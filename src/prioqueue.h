@@ -0,0 +1,48 @@
+/*
+ ============================================================================
+ Name        : prioqueue.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Ready queue of Preemptive Priority, as in the Linux O(1)
+               scheduler: one FIFO per priority level and a hierarchical
+               bitmap of non-empty levels, so push, pop and finding the
+               highest level are O(1) for any number of processes and up
+               to PRIO_MAX_LEVELS levels. Higher number is higher priority.
+               Aging raises every waiting process one level per step; the
+               levels are a ring, so a step moves one FIFO into the top
+               level instead of touching every process. Steps are taken
+               on the clock, not on the wait of each process: one queued
+               just before a step gains its first level at that step,
+               after less than a step of waiting, and a full step per
+               level from then on.
+ ============================================================================
+ */
+
+#ifndef PRIOQUEUE_H_
+#define PRIOQUEUE_H_
+
+#define PRIO_MAX_LEVELS (1 << 24)
+#define PRIO_BITMAP_DEPTH 4			/* 64^4 bits cover PRIO_MAX_LEVELS */
+
+typedef struct {
+	int *next;						/* Next process in same FIFO, -1 at tail */
+	int *head;						/* First process of every ring slot, -1 if empty */
+	int *tail;
+	unsigned long long *bits[PRIO_BITMAP_DEPTH];	/* Level 0 has a bit per slot, each level above a bit per word below */
+	int depth;
+	int slots;						/* Levels below the top one */
+	int top, topTail;				/* FIFO of the top level, where aging stops */
+	int minLevel;
+	int maxLevel;
+	long long steps;				/* Aging steps done */
+	int count;
+}prioQueue;
+
+int prioInit(prioQueue *, int, int, int);	/* Processes, lowest and highest priority. 0 on success, -1 if out of memory or too many levels */
+void prioFree(prioQueue *);
+void prioPush(prioQueue *, int, int, int);	/* Process, priority, flag putting it at head of its FIFO instead of tail */
+int prioTopLevel(const prioQueue *);		/* Current level of highest waiting process, queue must not be empty */
+int prioPop(prioQueue *);					/* Removes and returns first process of highest level */
+void prioAge(prioQueue *, long long);		/* Raises waiting processes till given number of aging steps is done */
+
+#endif /* PRIOQUEUE_H_ */
@@ -0,0 +1,178 @@
+/*
+ ============================================================================
+ Name        : proctable.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Structure of arrays process table and name interning
+ ============================================================================
+ */
+
+#include <string.h>
+#include "proctable.h"
+
+/**
+ * Function Name: 	procTableInit
+ * Function:		Allocates every column of the table from the arena of the run
+ * Input:			Table, arena, number of processes
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Table, arena
+ */
+
+int procTableInit(procTable *t, arena *mem, int numOfProcesses) {
+	size_t n = numOfProcesses > 0 ? numOfProcesses : 1;
+
+	memset(t, 0, sizeof(*t));
+	t->arrivalTime = arenaAlloc(mem, n * sizeof(simTime));
+	t->burstTime = arenaAlloc(mem, n * sizeof(simTime));
+	t->startTime = arenaAlloc(mem, n * sizeof(simTime));
+	t->finishTime = arenaAlloc(mem, n * sizeof(simTime));
+	t->waitingTime = arenaAlloc(mem, n * sizeof(simTime));
+	t->IsActiveFor = arenaAlloc(mem, n * sizeof(simTime));
+	t->priority = arenaAlloc(mem, n * sizeof(int));
+	t->name = arenaAlloc(mem, n * sizeof(unsigned));
+	if(t->arrivalTime == NULL || t->burstTime == NULL || t->startTime == NULL || t->finishTime == NULL ||
+			t->waitingTime == NULL || t->IsActiveFor == NULL || t->priority == NULL || t->name == NULL) {
+		return -1;
+	}
+	t->numOfProcesses = numOfProcesses;
+	return 0;
+}
+
+/**
+ * Function Name: 	procTableInitIo
+ * Function:		Allocates the I/O columns of a table, for a workload whose processes have I/O bursts
+ * Input:			Table initialised by procTableInit(), arena
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Table, arena
+ */
+
+int procTableInitIo(procTable *t, arena *mem) {
+	size_t n = t->numOfProcesses > 0 ? t->numOfProcesses : 1;
+
+	t->ioLeft = arenaAlloc(mem, n * sizeof(int));
+	t->nextBurst = arenaAlloc(mem, n * sizeof(unsigned));
+	t->ioTime = arenaAlloc(mem, n * sizeof(simTime));
+	return t->ioLeft && t->nextBurst && t->ioTime ? 0 : -1;
+}
+
+/**
+ * Function Name: 	procTableCopyIo
+ * Function:		Gives a copy of a table the I/O bursts of the original, if it has any. The bursts array is
+ * 					shared, only where each process stands in it is copied
+ * Input:			Copy (same processes in the same order), original, arena of the copy
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Copy, arena
+ */
+
+int procTableCopyIo(procTable *dst, const procTable *src, arena *mem) {
+	if(src->ioLeft == NULL) {
+		return 0;
+	}
+	if(procTableInitIo(dst, mem) != 0) {
+		return -1;
+	}
+	memcpy(dst->ioLeft, src->ioLeft, dst->numOfProcesses * sizeof(int));
+	memcpy(dst->nextBurst, src->nextBurst, dst->numOfProcesses * sizeof(unsigned));
+	dst->bursts = src->bursts;
+	dst->numBursts = src->numBursts;
+	return 0;
+}
+
+/**
+ * Function Name: 	procTotalBurst
+ * Function:		Sums burstTime column. Reads one contiguous array, which the compiler vectorizes. CPU bursts
+ * 					still ahead of processes with I/O are added
+ * Input:			Table
+ * Output:			Total burst time
+ * Affects:			Nothing
+ */
+
+simTime procTotalBurst(const procTable *t) {
+	const simTime *restrict burst = t->burstTime;
+	simTime sum = 0;
+	unsigned at;
+	int i, k;
+
+	for(i=0; i<t->numOfProcesses; i++) {
+		sum += burst[i];
+	}
+	for(i=0; t->ioLeft && i<t->numOfProcesses; i++) {
+		for(k=0, at=t->nextBurst[i] + 1; k<t->ioLeft[i]; k++, at+=2) {
+			sum += t->bursts[at];		/*CPU bursts following the I/O ones*/
+		}
+	}
+	return sum;
+}
+
+static size_t hashName(const char *s) {
+	size_t h = 2166136261u;			/*FNV-1a*/
+
+	while(*s) {
+		h = (h ^ (unsigned char)*s++) * 16777619u;
+	}
+	return h;
+}
+
+/* Hash table is rebuilt twice as big when half full. Old slots stay in arena till end of run */
+static int growSlots(stringTable *st) {
+	size_t slots = st->slots ? st->slots * 2 : 64, i, h;
+	unsigned *slot = arenaAlloc(st->mem, slots * sizeof(unsigned)), off;
+
+	if(slot == NULL) {
+		return -1;
+	}
+	for(i=0; i<st->slots; i++) {
+		if((off = st->slot[i]) != 0) {
+			for(h=hashName(st->buf + off - 1) & (slots - 1); slot[h]; h=(h + 1) & (slots - 1));
+			slot[h] = off;
+		}
+	}
+	st->slot = slot;
+	st->slots = slots;
+	return 0;
+}
+
+int stringTableInit(stringTable *st, arena *mem, size_t expectedBytes) {
+	memset(st, 0, sizeof(*st));
+	st->mem = mem;
+	st->size = expectedBytes > 64 ? expectedBytes : 64;
+	st->buf = arenaAlloc(mem, st->size);
+	return st->buf && growSlots(st) == 0 ? 0 : -1;
+}
+
+/**
+ * Function Name: 	intern
+ * Function:		Returns offset of name in string table, adding it if it is not there yet
+ * Input:			String table, name
+ * Output:			Offset, -1 if out of memory
+ * Affects:			String table, arena
+ */
+
+long intern(stringTable *st, const char *name) {
+	size_t len = strlen(name) + 1, h;
+	char *grown;
+
+	if(2 * (st->count + 1) > st->slots && growSlots(st) != 0) {
+		return -1;
+	}
+	for(h=hashName(name) & (st->slots - 1); st->slot[h]; h=(h + 1) & (st->slots - 1)) {
+		if(strcmp(st->buf + st->slot[h] - 1, name) == 0) {
+			return st->slot[h] - 1;
+		}
+	}
+
+	if(st->used + len > st->size) {
+		grown = arenaAlloc(st->mem, 2 * st->size + len);
+		if(grown == NULL) {
+			return -1;
+		}
+		memcpy(grown, st->buf, st->used);
+		st->buf = grown;
+		st->size = 2 * st->size + len;
+	}
+	memcpy(st->buf + st->used, name, len);
+	st->slot[h] = (unsigned)(st->used + 1);
+	st->count++;
+	st->used += len;
+	return st->used - len;
+}
@@ -0,0 +1,68 @@
+/*
+ ============================================================================
+ Name        : proctable.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Process table stored as structure of arrays. Every field is
+               its own contiguous array so that loops touching one or two
+               fields (total burst, shortest remaining burst) stream through
+               only those and can be vectorized. Names are interned into
+               one string table and referenced by offset.
+               A process may alternate CPU and I/O bursts. burstTime then
+               holds its current CPU burst and the ones after it come from
+               the bursts array; the I/O columns are only allocated for
+               workloads having any I/O, so tables without stay as small.
+ ============================================================================
+ */
+
+#ifndef PROCTABLE_H_
+#define PROCTABLE_H_
+
+#include <stddef.h>
+#include "arena.h"
+
+/* Simulated time. 64 bits so that millions of long jobs cannot overflow the clock */
+typedef long long simTime;
+
+typedef struct {
+	int numOfProcesses;
+	simTime *arrivalTime;
+	simTime *burstTime;			/* Remaining (CPU) burst, becomes zero as process gets executed */
+	int *priority;
+	simTime *startTime;
+	simTime *finishTime;
+	simTime *waitingTime;
+	simTime *IsActiveFor;		/* Executed time, i.e. original burst (all CPU bursts) once run is over */
+	int *ioLeft;				/* I/O bursts still ahead, NULL when no process has any */
+	unsigned *nextBurst;		/* Offset in bursts of next I/O burst, the CPU burst following it comes next */
+	simTime *ioTime;			/* Time spent blocked on I/O */
+	const simTime *bursts;		/* I/O, CPU pairs following first CPU burst of every process */
+	size_t numBursts;
+	unsigned *name;				/* Offset of name in string table */
+	const char *strings;		/* String table of NUL terminated names */
+	size_t stringsSize;
+}procTable;
+
+#define PROC_NAME(t, i) ((t)->strings + (t)->name[i])
+#define PROC_TABLE_BYTES (7 * sizeof(simTime) + sizeof(int) + sizeof(unsigned))	/* Arena bytes per process taken by procTableInit */
+#define PROC_IO_BYTES (sizeof(int) + sizeof(unsigned) + sizeof(simTime))	/* and by procTableInitIo */
+
+/* Builds a string table, storing every distinct name once */
+typedef struct {
+	char *buf;
+	size_t used;
+	size_t size;
+	unsigned *slot;				/* Open addressing hash of offset + 1, zero is empty */
+	size_t slots;
+	size_t count;
+	arena *mem;
+}stringTable;
+
+int procTableInit(procTable *, arena *, int);			/* Allocates all columns for given number of processes, returns 0 on success */
+int procTableInitIo(procTable *, arena *);				/* Allocates I/O columns of an initialised table, returns 0 on success */
+int procTableCopyIo(procTable *, const procTable *, arena *);	/* Copies I/O bursts of a table of the same processes, returns 0 on success */
+simTime procTotalBurst(const procTable *);				/* Sum of burstTime column */
+int stringTableInit(stringTable *, arena *, size_t);	/* Starts string table expecting given number of bytes, returns 0 on success */
+long intern(stringTable *, const char *);				/* Offset of name in string table, -1 if out of memory */
+
+#endif /* PROCTABLE_H_ */
@@ -0,0 +1,286 @@
+/*
+ ============================================================================
+ Name        : profile.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Phase timers, counters and event trace, see profile.h.
+               Totals are updated with relaxed atomic additions and events
+               claim their place in the buffer with one atomic increment,
+               so threads never wait on each other. Each thread keeps its
+               own stack of open phases.
+ ============================================================================
+ */
+
+#include "profile.h"
+
+#ifdef PROFILING
+
+#include <stdlib.h>
+#include <time.h>
+
+#define PROF_DEPTH 16		/* Deepest nesting of phases timed, deeper ones are ignored */
+
+#define ATOMIC_ADD(var, n) __atomic_fetch_add(&(var), n, __ATOMIC_RELAXED)
+
+enum {EVENT_PHASE, EVENT_DISPATCH};
+
+typedef struct {
+	int kind;					/* EVENT_PHASE or EVENT_DISPATCH */
+	int tid;					/* Thread it happened on */
+	int what;					/* Phase, or process dispatched */
+	long long ts;				/* Nanoseconds since profStart */
+	long long dur;				/* Length of phase in nanoseconds */
+	simTime start;				/* Simulated time and length of dispatch */
+	simTime length;
+}profEvent;
+
+typedef struct {
+	int depth;					/* Phases open, may exceed PROF_DEPTH */
+	int phase[PROF_DEPTH];
+	long long begun[PROF_DEPTH];	/* When each phase was entered */
+	long long resumed[PROF_DEPTH];	/* When each phase last got the thread back from one nested in it */
+	int tid;					/* Small id of the thread, 0 until first needed */
+}phaseStack;
+
+static const char *phaseName[PROF_PHASES] = {"load", "sort", "simulate", "stats", "output"};
+static const char *counterName[PROF_COUNTERS] = {"decisions", "queue_ops", "wakeups", "allocs", "alloc_bytes",
+		"arena_blocks"};
+
+int profEnabled = 0;
+int profSampleEvery = 0;
+
+static long long origin;
+static long long phaseNs[PROF_PHASES];
+static long long phaseCalls[PROF_PHASES];
+static long long counter[PROF_COUNTERS];
+static profEvent *events;
+static size_t maxEvents;
+static size_t numEvents;		/* Claimed so far, may run past maxEvents */
+static int numThreads;
+static __thread phaseStack stack;
+
+static long long nowNs(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int threadId(void) {
+	if(stack.tid == 0) {
+		stack.tid = ATOMIC_ADD(numThreads, 1) + 1;
+	}
+	return stack.tid;
+}
+
+/* Claims a place in the event buffer, NULL once it is full */
+static profEvent *newEvent(int kind, int what, long long ts) {
+	size_t i;
+
+	if(events == NULL) {
+		return NULL;
+	}
+	i = ATOMIC_ADD(numEvents, 1);
+	if(i >= maxEvents) {
+		return NULL;
+	}
+	events[i].kind = kind;
+	events[i].tid = threadId();
+	events[i].what = what;
+	events[i].ts = ts - origin;
+	return &events[i];
+}
+
+/**
+ * Function Name: 	profStart
+ * Function:		Clears what was gathered and turns profiling on
+ * Input:			Most events to keep (0 for no trace), dispatches per traced one (0 to trace phases only)
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Profiler
+ * NOTES:			Must be called before the threads it is to see are started.
+ */
+
+int profStart(size_t keep, int sampleEvery) {
+	int i;
+
+	free(events);
+	events = NULL;
+	if(keep > 0 && (events = malloc(keep * sizeof(profEvent))) == NULL) {
+		fprintf(stderr, "Out of memory for %zu profile events\n", keep);
+		return -1;
+	}
+	maxEvents = keep;
+	numEvents = 0;
+	for(i=0; i<PROF_PHASES; i++) {
+		phaseNs[i] = phaseCalls[i] = 0;
+	}
+	for(i=0; i<PROF_COUNTERS; i++) {
+		counter[i] = 0;
+	}
+	profSampleEvery = keep > 0 ? sampleEvery : 0;
+	origin = nowNs();
+	profEnabled = 1;
+	return 0;
+}
+
+void profStop(void) {
+	profEnabled = 0;
+}
+
+/**
+ * Function Name: 	profBegin
+ * Function:		Enters a phase on the calling thread. The phase it is nested in stops being charged
+ * Input:			Phase
+ * Output:			None
+ * Affects:			Stack of phases of the thread, time of enclosing phase
+ */
+
+void profBegin(int phase) {
+	long long now = nowNs();
+	int d = stack.depth;
+
+	if(d > 0 && d <= PROF_DEPTH) {
+		ATOMIC_ADD(phaseNs[stack.phase[d - 1]], now - stack.resumed[d - 1]);
+	}
+	if(d < PROF_DEPTH) {
+		stack.phase[d] = phase;
+		stack.begun[d] = stack.resumed[d] = now;
+	}
+	stack.depth++;
+}
+
+/**
+ * Function Name: 	profEnd
+ * Function:		Leaves the phase entered last on the calling thread, charging it the time not spent in
+ * 					phases nested in it. The enclosing phase is charged again from now on
+ * Input:			Phase
+ * Output:			None
+ * Affects:			Stack of phases of the thread, phase totals, event trace
+ * NOTES:			A phase entered before profiling was turned on is ignored.
+ */
+
+void profEnd(int phase) {
+	long long now = nowNs();
+	int d = stack.depth - 1;
+	profEvent *e;
+
+	if(d < 0) {
+		return;
+	}
+	stack.depth = d;
+	if(d >= PROF_DEPTH) {
+		return;
+	}
+	if(stack.phase[d] != phase) {
+		fprintf(stderr, "Profiler: %s ended inside %s\n", phaseName[phase], phaseName[stack.phase[d]]);
+	}
+	ATOMIC_ADD(phaseNs[stack.phase[d]], now - stack.resumed[d]);
+	ATOMIC_ADD(phaseCalls[stack.phase[d]], 1);
+	if(d > 0) {
+		stack.resumed[d - 1] = now;
+	}
+	if((e = newEvent(EVENT_PHASE, stack.phase[d], stack.begun[d])) != NULL) {
+		e->dur = now - stack.begun[d];
+	}
+}
+
+void profCount(int which, long long n) {
+	ATOMIC_ADD(counter[which], n);
+}
+
+void profDispatch(int index, simTime start, simTime length) {
+	profEvent *e = newEvent(EVENT_DISPATCH, index, nowNs());
+
+	if(e) {
+		e->start = start;
+		e->length = length;
+	}
+}
+
+/**
+ * Function Name: 	profReport
+ * Function:		Prints time charged to every phase, its share of all phases and the counters
+ * Input:			Stream
+ * Output:			None
+ * Affects:			Stream
+ */
+
+void profReport(FILE *out) {
+	long long total = 0;
+	int i;
+
+	for(i=0; i<PROF_PHASES; i++) {
+		total += phaseNs[i];
+	}
+	fprintf(out, "\n%-14s %10s %14s %7s\n", "Phase", "Calls", "Time (ms)", "Share");
+	for(i=0; i<PROF_PHASES; i++) {
+		fprintf(out, "%-14s %10lld %14.3f %6.1f%%\n", phaseName[i], phaseCalls[i], phaseNs[i] / 1e6,
+				total > 0 ? 100.0 * phaseNs[i] / total : 0.0);
+	}
+	fprintf(out, "%-14s %10s %14.3f\n\n", "total", "", total / 1e6);
+	for(i=0; i<PROF_COUNTERS; i++) {
+		fprintf(out, "%-14s %10lld\n", counterName[i], counter[i]);
+	}
+	if(events) {
+		fprintf(out, "%-14s %10zu", "trace_events", numEvents < maxEvents ? numEvents : maxEvents);
+		if(numEvents > maxEvents) {
+			fprintf(out, " (%zu dropped)", numEvents - maxEvents);
+		}
+		fprintf(out, "\n");
+	}
+}
+
+/* Prints nanoseconds as the microseconds Chrome traces count in */
+static void printUs(FILE *out, long long ns) {
+	fprintf(out, "%lld.%03lld", ns / 1000, ns % 1000);
+}
+
+/**
+ * Function Name: 	profWriteTrace
+ * Function:		Writes the events kept as Chrome trace JSON. Phases are complete ("X") events, nested
+ * 					ones inside those enclosing them; dispatches are instant ("i") events carrying the process
+ * 					and its simulated start and length
+ * Input:			File name
+ * Output:			0 on success, -1 if the file could not be written
+ * Affects:			File
+ * NOTES:			Call after the threads recording events have finished.
+ */
+
+int profWriteTrace(const char *name) {
+	size_t i, n = numEvents < maxEvents ? numEvents : maxEvents;
+	FILE *out = fopen(name, "w");
+	const profEvent *e;
+
+	if(out == NULL) {
+		fprintf(stderr, "Could not open %s for writing\n", name);
+		return -1;
+	}
+	fprintf(out, "{\"traceEvents\":[\n");
+	fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"schedalgos\"}}");
+	for(i=0; i<n; i++) {
+		e = &events[i];
+		fprintf(out, ",\n");
+		if(e->kind == EVENT_PHASE) {
+			fprintf(out, "{\"name\":\"%s\",\"cat\":\"phase\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":",
+					phaseName[e->what], e->tid);
+			printUs(out, e->ts);
+			fprintf(out, ",\"dur\":");
+			printUs(out, e->dur);
+			fprintf(out, "}");
+		} else {
+			fprintf(out, "{\"name\":\"dispatch\",\"cat\":\"engine\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":",
+					e->tid);
+			printUs(out, e->ts);
+			fprintf(out, ",\"args\":{\"process\":%d,\"start\":%lld,\"length\":%lld}}", e->what,
+					(long long)e->start, (long long)e->length);
+		}
+	}
+	fprintf(out, "\n],\"displayTimeUnit\":\"ns\"}\n");
+	if(fclose(out) != 0) {
+		fprintf(stderr, "Could not write %s\n", name);
+		return -1;
+	}
+	return 0;
+}
+
+#endif /* PROFILING */
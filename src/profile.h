@@ -0,0 +1,72 @@
+/*
+ ============================================================================
+ Name        : profile.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Instrumentation of the simulator itself. While profiling is
+               on (profStart) it keeps
+                   phase timers  wall time spent loading, sorting,
+                                 simulating, computing statistics and
+                                 writing output, from clock_gettime. Phases
+                                 nest; each one is charged its own time
+                                 only, so the phases add up to the run
+                   counters      scheduling decisions, ready set
+                                 operations, wakeups, arena allocations
+                   event trace   every phase and one in sampleEvery
+                                 dispatches, written by profWriteTrace as
+                                 Chrome trace JSON (chrome://tracing,
+                                 Perfetto)
+               Counters and timers are shared by all threads of the process.
+               While profiling is off each hook costs one predictable
+               branch. Built with NDEBUG (make release) every hook is
+               compiled out and the functions below do not exist.
+ ============================================================================
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdio.h>
+#include "proctable.h"
+
+enum {PROF_LOAD, PROF_SORT, PROF_SIMULATE, PROF_STATS, PROF_OUTPUT, PROF_PHASES};
+enum {PROF_DECISIONS, PROF_QUEUE_OPS, PROF_WAKEUPS, PROF_ALLOCS, PROF_ALLOC_BYTES, PROF_BLOCKS, PROF_COUNTERS};
+
+#ifndef NDEBUG
+#define PROFILING 1
+#endif
+
+#ifdef PROFILING
+
+extern int profEnabled;			/* Set by profStart, cleared by profStop */
+extern int profSampleEvery;		/* Dispatches per traced one, 0 = none traced */
+
+int profStart(size_t, int);			/* Most events kept, dispatches per traced one (0 = none). 0 on success */
+void profStop(void);				/* Stops counting, what was gathered stays for the report and trace */
+void profBegin(int);				/* Enters phase on this thread */
+void profEnd(int);					/* Leaves phase entered last on this thread */
+void profCount(int, long long);		/* Adds to counter */
+void profDispatch(int, simTime, simTime);	/* Traces dispatch of a process: process, simulated start and length */
+void profReport(FILE *);			/* Prints phase times and counters */
+int profWriteTrace(const char *);	/* Writes events as Chrome trace JSON, returns 0 on success */
+
+#define PROF_BEGIN(phase) do { if(profEnabled) profBegin(phase); } while(0)
+#define PROF_END(phase) do { if(profEnabled) profEnd(phase); } while(0)
+#define PROF_COUNT(counter, n) do { if(profEnabled) profCount(counter, n); } while(0)
+#define PROF_TALLY(expr) ((void)(expr))		/* Local bookkeeping only profiling reads */
+#define PROF_DISPATCH(decisions, process, start, length) do { \
+		if(profSampleEvery > 0 && profEnabled && (decisions) % profSampleEvery == 0) \
+			profDispatch(process, start, length); \
+	} while(0)
+
+#else
+
+#define PROF_BEGIN(phase) ((void)0)
+#define PROF_END(phase) ((void)0)
+#define PROF_COUNT(counter, n) ((void)0)
+#define PROF_TALLY(expr) ((void)0)
+#define PROF_DISPATCH(decisions, process, start, length) ((void)0)
+
+#endif /* PROFILING */
+
+#endif /* PROFILE_H_ */
@@ -0,0 +1,258 @@
+/*
+ ============================================================================
+ Name        : rbtree.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Red-black tree (as in Cormen et al.) with a sentinel node in
+               place of NULL children, see rbtree.h.
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include "rbtree.h"
+
+/* Tells whether process a goes left of process b */
+static int before(const rbTree *t, int a, int b) {
+	return t->key[a] < t->key[b] || (t->key[a] == t->key[b] && a < b);
+}
+
+static void rotateLeft(rbTree *t, int x) {
+	int y = t->right[x];
+
+	t->right[x] = t->left[y];
+	if(t->left[y] != t->nil) {
+		t->parent[t->left[y]] = x;
+	}
+	t->parent[y] = t->parent[x];
+	if(t->parent[x] == t->nil) {
+		t->root = y;
+	} else if(x == t->left[t->parent[x]]) {
+		t->left[t->parent[x]] = y;
+	} else {
+		t->right[t->parent[x]] = y;
+	}
+	t->left[y] = x;
+	t->parent[x] = y;
+}
+
+static void rotateRight(rbTree *t, int x) {
+	int y = t->left[x];
+
+	t->left[x] = t->right[y];
+	if(t->right[y] != t->nil) {
+		t->parent[t->right[y]] = x;
+	}
+	t->parent[y] = t->parent[x];
+	if(t->parent[x] == t->nil) {
+		t->root = y;
+	} else if(x == t->right[t->parent[x]]) {
+		t->right[t->parent[x]] = y;
+	} else {
+		t->left[t->parent[x]] = y;
+	}
+	t->right[y] = x;
+	t->parent[x] = y;
+}
+
+/**
+ * Function Name: 	rbInit
+ * Function:		Allocates an empty tree able to hold process indices 0..capacity-1
+ * Input:			Tree, capacity, array of keys indexed by process
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Tree
+ */
+
+int rbInit(rbTree *t, int capacity, const long long *key) {
+	if(capacity < 0) {
+		capacity = 0;
+	}
+	t->left = malloc((capacity + 1) * (3 * sizeof(int) + sizeof(char)));	/*One allocation for all four arrays*/
+	if(t->left == NULL) {
+		return -1;
+	}
+	t->right = t->left + capacity + 1;
+	t->parent = t->right + capacity + 1;
+	t->red = (char *)(t->parent + capacity + 1);
+	t->key = key;
+	t->nil = capacity;
+	t->root = t->nil;
+	t->red[t->nil] = 0;
+	t->count = 0;
+	return 0;
+}
+
+void rbFree(rbTree *t) {
+	free(t->left);
+	t->left = NULL;
+}
+
+void rbInsert(rbTree *t, int z) {
+	int y = t->nil, x = t->root, u;
+
+	while(x != t->nil) {
+		y = x;
+		x = before(t, z, x) ? t->left[x] : t->right[x];
+	}
+	t->parent[z] = y;
+	if(y == t->nil) {
+		t->root = z;
+	} else if(before(t, z, y)) {
+		t->left[y] = z;
+	} else {
+		t->right[y] = z;
+	}
+	t->left[z] = t->right[z] = t->nil;
+	t->red[z] = 1;
+	t->count++;
+
+	/*Restore red-black properties going up from the new red node*/
+	while(t->red[t->parent[z]]) {
+		y = t->parent[z];
+		u = t->parent[y];
+		if(y == t->left[u]) {
+			x = t->right[u];
+			if(t->red[x]) {
+				t->red[y] = t->red[x] = 0;
+				t->red[u] = 1;
+				z = u;
+				continue;
+			}
+			if(z == t->right[y]) {
+				z = y;
+				rotateLeft(t, z);
+				y = t->parent[z];
+			}
+			t->red[y] = 0;
+			t->red[u] = 1;
+			rotateRight(t, u);
+		} else {
+			x = t->left[u];
+			if(t->red[x]) {
+				t->red[y] = t->red[x] = 0;
+				t->red[u] = 1;
+				z = u;
+				continue;
+			}
+			if(z == t->left[y]) {
+				z = y;
+				rotateRight(t, z);
+				y = t->parent[z];
+			}
+			t->red[y] = 0;
+			t->red[u] = 1;
+			rotateLeft(t, u);
+		}
+	}
+	t->red[t->root] = 0;
+}
+
+/* Puts subtree v in place of subtree u */
+static void transplant(rbTree *t, int u, int v) {
+	if(t->parent[u] == t->nil) {
+		t->root = v;
+	} else if(u == t->left[t->parent[u]]) {
+		t->left[t->parent[u]] = v;
+	} else {
+		t->right[t->parent[u]] = v;
+	}
+	t->parent[v] = t->parent[u];	/*Sentinel parent is set too, fixup below relies on it*/
+}
+
+void rbRemove(rbTree *t, int z) {
+	int y = z, x, w, wasRed = t->red[z];
+
+	if(t->left[z] == t->nil) {
+		x = t->right[z];
+		transplant(t, z, x);
+	} else if(t->right[z] == t->nil) {
+		x = t->left[z];
+		transplant(t, z, x);
+	} else {
+		y = t->right[z];
+		while(t->left[y] != t->nil) {
+			y = t->left[y];
+		}
+		wasRed = t->red[y];
+		x = t->right[y];
+		if(t->parent[y] == z) {
+			t->parent[x] = y;
+		} else {
+			transplant(t, y, x);
+			t->right[y] = t->right[z];
+			t->parent[t->right[y]] = y;
+		}
+		transplant(t, z, y);
+		t->left[y] = t->left[z];
+		t->parent[t->left[y]] = y;
+		t->red[y] = t->red[z];
+	}
+	t->count--;
+	if(wasRed) {
+		return;
+	}
+
+	/*A black node went away, push the extra black of x up or resolve it by rotations*/
+	while(x != t->root && !t->red[x]) {
+		if(x == t->left[t->parent[x]]) {
+			w = t->right[t->parent[x]];
+			if(t->red[w]) {
+				t->red[w] = 0;
+				t->red[t->parent[x]] = 1;
+				rotateLeft(t, t->parent[x]);
+				w = t->right[t->parent[x]];
+			}
+			if(!t->red[t->left[w]] && !t->red[t->right[w]]) {
+				t->red[w] = 1;
+				x = t->parent[x];
+				continue;
+			}
+			if(!t->red[t->right[w]]) {
+				t->red[t->left[w]] = 0;
+				t->red[w] = 1;
+				rotateRight(t, w);
+				w = t->right[t->parent[x]];
+			}
+			t->red[w] = t->red[t->parent[x]];
+			t->red[t->parent[x]] = 0;
+			t->red[t->right[w]] = 0;
+			rotateLeft(t, t->parent[x]);
+		} else {
+			w = t->left[t->parent[x]];
+			if(t->red[w]) {
+				t->red[w] = 0;
+				t->red[t->parent[x]] = 1;
+				rotateRight(t, t->parent[x]);
+				w = t->left[t->parent[x]];
+			}
+			if(!t->red[t->right[w]] && !t->red[t->left[w]]) {
+				t->red[w] = 1;
+				x = t->parent[x];
+				continue;
+			}
+			if(!t->red[t->left[w]]) {
+				t->red[t->right[w]] = 0;
+				t->red[w] = 1;
+				rotateLeft(t, w);
+				w = t->left[t->parent[x]];
+			}
+			t->red[w] = t->red[t->parent[x]];
+			t->red[t->parent[x]] = 0;
+			t->red[t->left[w]] = 0;
+			rotateRight(t, t->parent[x]);
+		}
+		x = t->root;
+	}
+	t->red[x] = 0;
+}
+
+int rbFirst(const rbTree *t) {
+	int x = t->root;
+
+	if(x == t->nil) {
+		return -1;
+	}
+	while(t->left[x] != t->nil) {
+		x = t->left[x];
+	}
+	return x;
+}
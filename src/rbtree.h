@@ -0,0 +1,34 @@
+/*
+ ============================================================================
+ Name        : rbtree.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Red-black tree of process indices, used as ready queue of the
+               Completely Fair Scheduler keyed on virtual runtime. Links live
+               in arrays indexed by process, so the tree allocates once and
+               insert, remove and leftmost are O(log n). Ties are broken by
+               process index, i.e. by arrival order.
+ ============================================================================
+ */
+
+#ifndef RBTREE_H_
+#define RBTREE_H_
+
+typedef struct {
+	int *left;
+	int *right;
+	int *parent;
+	char *red;
+	const long long *key;		/* Key of every process, must not change while it is in the tree */
+	int root;
+	int nil;					/* Sentinel node, index capacity */
+	int count;
+}rbTree;
+
+int rbInit(rbTree *, int, const long long *);	/* Allocates tree for given number of processes keyed on array, 0 on success */
+void rbFree(rbTree *);
+void rbInsert(rbTree *, int);				/* Inserts process index */
+void rbRemove(rbTree *, int);				/* Removes process index already in tree */
+int rbFirst(const rbTree *);				/* Process having smallest key, -1 if empty */
+
+#endif /* RBTREE_H_ */
@@ -0,0 +1,274 @@
+/*
+ ============================================================================
+ Name        : replay.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Fleet replay, see replay.h
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "replay.h"
+#include "threadpool.h"
+
+enum {WAITING, TURNAROUND, RESPONSE, NUM_METRICS};
+
+/* State shared by every task of a replay */
+typedef struct {
+	const replaySpec *spec;
+	threadPool pool;
+	arena *workerMem;			/* One per worker, holds metric values of the traces it ran */
+}replayShared;
+
+/* One trace of the replay */
+typedef struct {
+	char *path;
+	char *name;					/* Handed over to the result */
+	off_t size;					/* Bytes of trace file, a rough measure of its run time */
+	simTime *value;				/* NUM_METRICS columns of processes values, in arena of the worker that ran it */
+	replayTrace *result;
+	replayShared *shared;
+}replayJob;
+
+static int byName(const void *a, const void *b) {
+	return strcmp(((const replayJob *)a)->name, ((const replayJob *)b)->name);
+}
+
+static int bySize(const void *a, const void *b) {
+	off_t x = (*(replayJob * const *)a)->size, y = (*(replayJob * const *)b)->size;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * Function Name: 	listTraces
+ * Function:		Collects regular files of a directory, hidden ones left out, in file name order
+ * Input:			Directory, pointers receiving job array and its length
+ * Output:			0 on success, -1 if directory cannot be read or out of memory (message already printed)
+ * Affects:			Nothing
+ */
+
+static int listTraces(const char *dir, replayJob **jobs, int *count) {
+	DIR *d = opendir(dir);
+	struct dirent *e;
+	struct stat st;
+	replayJob *job = NULL, *grown;
+	size_t length;
+	int n = 0, capacity = 0, ret = 0;
+
+	if(d == NULL) {
+		perror(dir);
+		return -1;
+	}
+	while(ret == 0 && (e = readdir(d)) != NULL) {
+		if(e->d_name[0] == '.') {
+			continue;
+		}
+		if(n == capacity) {
+			capacity = capacity ? 2 * capacity : 64;
+			grown = realloc(job, capacity * sizeof(replayJob));
+			if(grown == NULL) {
+				ret = -1;
+				break;
+			}
+			job = grown;
+		}
+		length = strlen(dir) + strlen(e->d_name) + 2;
+		memset(&job[n], 0, sizeof(replayJob));
+		job[n].path = malloc(length);
+		job[n].name = strdup(e->d_name);
+		if(job[n].path == NULL || job[n].name == NULL) {
+			free(job[n].path);
+			free(job[n].name);
+			ret = -1;
+			break;
+		}
+		snprintf(job[n].path, length, "%s/%s", dir, e->d_name);
+		if(stat(job[n].path, &st) != 0 || !S_ISREG(st.st_mode)) {
+			free(job[n].path);
+			free(job[n].name);
+			continue;
+		}
+		job[n++].size = st.st_size;
+	}
+	closedir(d);
+
+	if(ret != 0) {
+		fprintf(stderr, "Not enough memory to list %s\n", dir);
+		while(n > 0) {
+			n--;
+			free(job[n].path);
+			free(job[n].name);
+		}
+		free(job);
+		return -1;
+	}
+	if(n > 0) {
+		qsort(job, n, sizeof(replayJob), byName);
+	}
+	*jobs = job;
+	*count = n;
+	return 0;
+}
+
+/**
+ * Function Name: 	replayTask
+ * Function:		Loads and runs one trace, then keeps averages of the run and the metrics of every process
+ * Input:			Job of the trace
+ * Output:			None
+ * Affects:			Result of the trace, arena of the worker running it
+ */
+
+static void replayTask(void *arg) {
+	replayJob *job = arg;
+	replayShared *shared = job->shared;
+	replayTrace *r = job->result;
+	const procTable *t;
+	arena loadMem;
+	workload wl;
+	schedResult run;
+	simTime arr, turnaround;
+	int n, i;
+
+	memset(&run, 0, sizeof(run));
+	r->failed = 1;
+	if(loadWorkload(job->path, &loadMem, 0, &wl) == 0 && sched_run(shared->spec->algo, &wl, &shared->spec->params, &run) == 0) {
+		t = &run.table;
+		n = t->numOfProcesses;
+		job->value = arenaAlloc(&shared->workerMem[poolWorker(&shared->pool)], (size_t)NUM_METRICS * n * sizeof(simTime));
+		if(job->value) {
+			/*Same definitions as computeStats()*/
+			for(i=0; i<n; i++) {
+				arr = run.arrivalIsPriority ? 0 : t->arrivalTime[i];
+				turnaround = t->finishTime[i] - arr;
+				job->value[(size_t)WAITING * n + i] = turnaround - t->IsActiveFor[i] - (t->ioTime ? t->ioTime[i] : 0);
+				job->value[(size_t)TURNAROUND * n + i] = turnaround;
+				job->value[(size_t)RESPONSE * n + i] = t->startTime[i] - arr;
+			}
+			r->processes = n;
+			r->avgWaiting = run.avgWaiting;
+			r->avgTurnaround = run.avgTurnaround;
+			r->contextSwitches = run.contextSwitches;
+			r->totalTime = run.totalTime;
+			r->failed = 0;
+		}
+	}
+	sched_result_free(&run);
+	freeWorkload(&wl);
+	arenaFree(&loadMem);
+}
+
+/* Gathers values of every trace that ran and summarizes them, 0 on success */
+static int mergeMetrics(replayJob *job, int count, replayResult *result) {
+	metricSummary *summary[NUM_METRICS] = { &result->waiting, &result->turnaround, &result->response };
+	simTime *all;
+	long long total = 0;
+	int i, m, n, at;
+
+	for(i=0; i<count; i++) {
+		total += job[i].result->failed ? 0 : job[i].result->processes;
+	}
+	if(total > INT_MAX || (all = malloc((total + 1) * sizeof(simTime))) == NULL) {
+		return -1;
+	}
+	result->processes = (int)total;
+	for(m=0; m<NUM_METRICS; m++) {
+		at = 0;
+		for(i=0; i<count; i++) {
+			n = job[i].result->processes;
+			if(!job[i].result->failed && n > 0) {
+				memcpy(all + at, job[i].value + (size_t)m * n, n * sizeof(simTime));
+				at += n;
+			}
+		}
+		summarizeValues(all, at, summary[m]);
+	}
+	free(all);
+	return 0;
+}
+
+/**
+ * Function Name: 	runReplay
+ * Function:		Runs the algorithm of the spec on every trace of a directory in parallel and summarizes
+ * 					the whole fleet
+ * Input:			Directory, spec, result to fill
+ * Output:			0 on success (some traces may have failed, see result), -1 if directory cannot be read,
+ * 					threads cannot be started or out of memory
+ * Affects:			Result
+ * NOTES:			Traces are submitted smallest first. Deques are filled in turn and every worker runs its
+ * 					newest task first, so each starts on the largest traces it got and the small ones left at
+ * 					the end even out the load.
+ */
+
+int runReplay(const char *dir, const replaySpec *spec, replayResult *result) {
+	replayShared shared;
+	replayJob *job = NULL, **order = NULL;
+	int count = 0, i, ok, started = 0;
+
+	memset(result, 0, sizeof(*result));
+	shared.spec = spec;
+	shared.workerMem = NULL;
+	if(listTraces(dir, &job, &count) != 0) {
+		return -1;
+	}
+	result->trace = calloc(count + 1, sizeof(replayTrace));
+	order = malloc((count + 1) * sizeof(replayJob *));
+	ok = result->trace != NULL && order != NULL && poolInit(&shared.pool, spec->numThreads) == 0;
+	if(ok) {
+		started = 1;
+		shared.workerMem = calloc(shared.pool.numWorkers, sizeof(arena));
+		ok = shared.workerMem != NULL;
+	}
+
+	if(ok) {
+		result->numTraces = count;
+		for(i=0; i<count; i++) {
+			job[i].result = &result->trace[i];
+			job[i].shared = &shared;
+			result->trace[i].name = job[i].name;
+			job[i].name = NULL;
+			order[i] = &job[i];
+		}
+		qsort(order, count, sizeof(replayJob *), bySize);
+		for(i=0; i<count; i++) {
+			if(poolSubmit(&shared.pool, replayTask, order[i]) != 0) {
+				order[i]->result->failed = 1;
+			}
+		}
+		poolWait(&shared.pool);
+		for(i=0; i<count; i++) {
+			result->failed += result->trace[i].failed;
+		}
+		ok = mergeMetrics(job, count, result) == 0;
+	}
+
+	if(started) {
+		poolDestroy(&shared.pool);
+	}
+	for(i=0; shared.workerMem && i<shared.pool.numWorkers; i++) {
+		arenaFree(&shared.workerMem[i]);
+	}
+	for(i=0; i<count; i++) {
+		free(job[i].path);
+		free(job[i].name);
+	}
+	free(shared.workerMem);
+	free(order);
+	free(job);
+	return ok ? 0 : -1;
+}
+
+void replayFree(replayResult *result) {
+	int i;
+
+	for(i=0; i<result->numTraces; i++) {
+		free(result->trace[i].name);
+	}
+	free(result->trace);
+	memset(result, 0, sizeof(*result));
+}
@@ -0,0 +1,53 @@
+/*
+ ============================================================================
+ Name        : replay.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Fleet replay. Runs one algorithm on every trace of a
+               directory, one trace per task of a work stealing thread
+               pool. Every task loads and simulates its trace in arenas of
+               its own and leaves the ready wait, turnaround and response
+               time of each process in the arena of the worker thread that
+               ran it, so workers share nothing while they run. When all
+               traces are done the per worker values are merged into
+               percentiles over every process of the fleet.
+ ============================================================================
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "sched.h"
+#include "stats.h"
+
+typedef struct {
+	int algo;					/* ALGO_FCFS .. ALGO_LAST */
+	schedParams params;			/* Of every run, callbacks and checkpoints must be NULL */
+	int numThreads;				/* 0 = one per CPU */
+}replaySpec;
+
+typedef struct {
+	char *name;					/* File name inside the directory */
+	int processes;
+	double avgWaiting;			/* Same definitions as final table: WTime */
+	double avgTurnaround;		/* and TATime */
+	long long contextSwitches;
+	simTime totalTime;
+	int failed;					/* Trace could not be loaded or run */
+}replayTrace;
+
+typedef struct {
+	replayTrace *trace;			/* In file name order */
+	int numTraces;
+	int failed;					/* Traces that could not be loaded or run */
+	int processes;				/* Processes of every trace that ran */
+	metricSummary waiting;		/* Over those processes, as in runStats */
+	metricSummary turnaround;
+	metricSummary response;
+}replayResult;
+
+int runReplay(const char *, const replaySpec *, replayResult *);	/* Directory, spec, result. 0 on success, -1 if directory
+																	   cannot be read or out of memory (release result anyway) */
+void replayFree(replayResult *);
+
+#endif /* REPLAY_H_ */
@@ -0,0 +1,191 @@
+/*
+ ============================================================================
+ Name        : sched.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Library interface of the schedulers, see sched.h
+ ============================================================================
+ */
+
+#include <string.h>
+#include "sched.h"
+#include "sort.h"
+#include "profile.h"
+
+/* Copies workload into the result as the algorithm needs it and sorts it */
+static int prepare(int algo, const workload *wl, const schedParams *params, schedResult *result) {
+	const procTable *src = &wl->table;
+	procTable *t = &result->table;
+	int n = src->numOfProcesses, i, sorted;
+
+	if(arenaInit(&result->mem, n * (PROC_TABLE_BYTES + (src->ioLeft ? PROC_IO_BYTES : 0))) != 0 ||
+			procTableInit(t, &result->mem, n) != 0 || procTableCopyIo(t, src, &result->mem) != 0) {
+		return -1;
+	}
+	for(i=0; i<n; i++) {
+		t->arrivalTime[i] = algo == ALGO_PRIORITY && wl->hasPriority ? src->priority[i] : src->arrivalTime[i];
+	}
+	memcpy(t->burstTime, src->burstTime, n * sizeof(simTime));
+	memcpy(t->priority, src->priority, n * sizeof(int));
+	memcpy(t->name, src->name, n * sizeof(unsigned));
+	t->strings = src->strings;
+	t->stringsSize = src->stringsSize;
+	result->arrivalIsPriority = algo == ALGO_PRIORITY;
+
+	PROF_BEGIN(PROF_SORT);
+	sorted = params->presorted ||
+			sortProcesses(t, algo == ALGO_PRIORITY ? SORT_BY_PRIORITY_BIT : SORT_BY_ARRIVAL) == 0;
+	PROF_END(PROF_SORT);
+	return sorted ? 0 : -1;
+}
+
+/* Averages and counters of a finished run */
+static void summarize(schedResult *result, const engineCounters *c) {
+	const procTable *t = &result->table;
+	double waiting = 0, turnaround = 0;
+	int n = t->numOfProcesses, i;
+
+	for(i=0; i<n; i++) {
+		waiting += t->waitingTime[i];
+		turnaround += t->finishTime[i] - (result->arrivalIsPriority ? 0 : t->arrivalTime[i]);
+	}
+	if(n > 0) {
+		result->avgWaiting = waiting / n;
+		result->avgTurnaround = turnaround / n;
+	}
+	result->contextSwitches = c->switches;
+	result->preemptions = c->preemptions;
+	result->idleTime = c->idleTime;
+	result->switchTime = c->switchTime;
+	result->maxQueue = c->maxQueue;
+	if(result->totalTime > 0) {
+		result->avgQueue = (double)c->queueArea / result->totalTime;
+	}
+	PROF_COUNT(PROF_DECISIONS, c->decisions);
+	PROF_COUNT(PROF_QUEUE_OPS, c->queueOps);
+	PROF_COUNT(PROF_WAKEUPS, c->wakeups);
+}
+
+/**
+ * Function Name: 	sched_run
+ * Function:		Runs one algorithm on a private copy of the workload
+ * Input:			Algorithm (ALGO_FCFS .. ALGO_LAST), workload, parameters, result to fill
+ * Output:			0 on success, -1 if out of memory, a quantum is not positive, balancing is unknown,
+ * 					more than one CPU is asked for an algorithm after ALGO_RR or checkpoints for one other than
+ * 					ALGO_FCFS, ALGO_SJFP or ALGO_RR on one CPU, more than one CPU or checkpoints are asked for a
+ * 					workload with I/O bursts, or ALGO_POLICY has no policy or it fails
+ * Affects:			Result (release with sched_result_free even on failure), checkpoint log of parameters
+ * NOTES:			For ALGO_PRIORITY priority of the workload is copied into arrivalTime and every process
+ * 					is taken as arrived at 0, as the interactive version always did.
+ */
+
+int sched_run(int algo, const workload *wl, const schedParams *params, schedResult *result) {
+	procTable *t = &result->table;
+	smpParams sp = { params->numCpus, params->balance, params->quantum, params->migrationCost, params->switchCost };
+	smpCounters counters;
+	engineCounters *c = &counters.engine;
+	int smp = params->numCpus > 1;
+
+	memset(result, 0, sizeof(*result));
+	if(algo < ALGO_FCFS || algo > ALGO_LAST || (algo == ALGO_RR && params->quantum <= 0) ||
+			(smp && (algo > ALGO_RR || params->balance < BALANCE_GLOBAL || params->balance > BALANCE_STEAL)) ||
+			(params->checkpoints && (smp || algo == ALGO_PRIORITY || algo > ALGO_RR)) ||
+			(wl->table.ioLeft && (smp || params->checkpoints)) ||
+			(algo == ALGO_POLICY && (params->policy == NULL || (params->policy->flags & POLICY_ARRIVE_AT_ZERO)))) {
+		return -1;
+	}
+	if(params->switchCost < 0 || prepare(algo, wl, params, result) != 0) {
+		return -1;
+	}
+
+	PROF_BEGIN(PROF_SIMULATE);
+	if(smp) {
+		result->totalTime = simulateSmp(t, algo, &sp, params->onCpuRun, params->arg, &counters);
+		result->migrations = counters.migrations;
+		result->steals = counters.steals;
+	} else if(algo == ALGO_PRIORITY_PREEMPTIVE) {
+		result->totalTime = simulatePriority(t, params->agingInterval, params->switchCost, params->onRun, params->arg, c);
+	} else if(algo == ALGO_MLFQ) {
+		result->totalTime = simulateMlfq(t, &params->mlfq, params->switchCost, params->onRun, params->arg, c);
+	} else if(algo == ALGO_CFS) {
+		result->totalTime = simulateCfs(t, &params->cfs, params->switchCost, params->onRun, params->arg, c);
+	} else if(algo == ALGO_POLICY) {
+		result->totalTime = simulatePolicy(t, params->policy, params->policyParams, params->switchCost, params->onRun,
+				params->arg, c);
+	} else {
+		if(params->checkpoints) {
+			checkpointTruncate(params->checkpoints, 0);
+		}
+		result->totalTime = simulateFrom(t, algo, params->quantum, params->switchCost, params->checkpoints, -1,
+				params->onRun, params->arg, c);
+	}
+	PROF_END(PROF_SIMULATE);
+	if(result->totalTime < 0) {
+		return -1;
+	}
+	summarize(result, c);
+	return 0;
+}
+
+/**
+ * Function Name: 	sched_rerun
+ * Function:		Runs a changed workload resuming from the last checkpoint of the previous run taken before the
+ * 					first changed process (in arrival order). What came before is copied from the previous result,
+ * 					so simulation costs time in proportion to the part of the run after the change
+ * Input:			Algorithm and parameters of the previous run (its checkpoint log included), changed workload,
+ * 					result of previous run, result to fill
+ * Output:			0 on success, -1 if out of memory or bad arguments (as for sched_run(), and a log is needed, so
+ * 					workloads with I/O bursts cannot be rerun)
+ * Affects:			Result, checkpoint log (now the one of the new run, so it may serve the next rerun with the
+ * 					new result)
+ * NOTES:			Only onRun calls after the checkpoint resumed from are made. Copying, sorting and averaging
+ * 					still touch the whole table, pass presorted workloads to keep them cheap.
+ */
+
+int sched_rerun(int algo, const workload *wl, const schedParams *params, const schedResult *prev, schedResult *result) {
+	procTable *t = &result->table;
+	const procTable *old = &prev->table;
+	checkpointLog *log = params->checkpoints;
+	engineCounters c;
+	int n = wl->table.numOfProcesses, changed, resume;
+	size_t prefix;
+
+	memset(result, 0, sizeof(*result));
+	if((algo != ALGO_FCFS && algo != ALGO_SJFP && algo != ALGO_RR) || (algo == ALGO_RR && params->quantum <= 0) ||
+			params->numCpus > 1 || params->switchCost < 0 || log == NULL || wl->table.ioLeft ||
+			prepare(algo, wl, params, result) != 0) {
+		return -1;
+	}
+
+	/*First process differing from previous run, whose table holds original burst in IsActiveFor*/
+	for(changed=0; changed<n && changed<old->numOfProcesses; changed++) {
+		if(t->arrivalTime[changed] != old->arrivalTime[changed] || t->burstTime[changed] != old->IsActiveFor[changed]) {
+			break;
+		}
+	}
+	resume = checkpointFind(log, changed);
+	checkpointTruncate(log, resume + 1);
+
+	/*Processes admitted before the checkpoint keep what they got, queued ones are restored by the engine*/
+	if(resume >= 0) {
+		prefix = log->cp[resume].nextArrival * sizeof(simTime);
+		memcpy(t->startTime, old->startTime, prefix);
+		memcpy(t->finishTime, old->finishTime, prefix);
+		memcpy(t->waitingTime, old->waitingTime, prefix);
+		memcpy(t->IsActiveFor, old->IsActiveFor, prefix);
+		memset(t->burstTime, 0, prefix);
+	}
+	PROF_BEGIN(PROF_SIMULATE);
+	result->totalTime = simulateFrom(t, algo, params->quantum, params->switchCost, log, resume, params->onRun, params->arg, &c);
+	PROF_END(PROF_SIMULATE);
+	if(result->totalTime < 0) {
+		return -1;
+	}
+	summarize(result, &c);
+	return 0;
+}
+
+void sched_result_free(schedResult *result) {
+	arenaFree(&result->mem);
+	memset(&result->table, 0, sizeof(result->table));
+}
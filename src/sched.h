@@ -0,0 +1,65 @@
+/*
+ ============================================================================
+ Name        : sched.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Library interface of the schedulers. sched_run() copies the
+               workload into an arena of its own, orders it as the
+               algorithm needs, simulates it and returns the executed table
+               with its averages. It keeps no global state and does no I/O,
+               so any number of threads may call it at once on the same
+               workload. With numCpus above one the run is simulated on that
+               many CPUs by simulateSmp(). Built as libsched.a / libsched.so
+               (make lib).
+ ============================================================================
+ */
+
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#include "engine.h"
+#include "smp.h"
+#include "workload.h"
+#include "arena.h"
+
+typedef struct {
+	simTime quantum;			/* Round Robin time quantum */
+	int presorted;				/* Table already in the order the algorithm needs, skip sorting */
+	runCallback onRun;			/* Called for every run of the CPU, may be NULL */
+	void *arg;					/* Passed to onRun and onCpuRun */
+	int numCpus;				/* 0 or 1 for the single CPU engine, more for ALGO_FCFS .. ALGO_RR only */
+	int balance;				/* More than one CPU: BALANCE_GLOBAL, BALANCE_PERCPU or BALANCE_STEAL */
+	simTime migrationCost;		/* More than one CPU: ticks lost when a process resumes on another CPU */
+	cpuRunCallback onCpuRun;	/* More than one CPU: called for every run of every CPU instead of onRun, may be NULL */
+	simTime agingInterval;		/* Preemptive Priority: ticks per level gained while waiting, 0 = no aging */
+	mlfqParams mlfq;			/* Multilevel Feedback Queue: levels, quanta and boost */
+	cfsParams cfs;				/* Completely Fair Scheduler: latency and minimum granularity */
+	checkpointLog *checkpoints;	/* ALGO_FCFS, ALGO_SJFP, ALGO_RR on one CPU: filled with checkpoints of the run, may be NULL */
+	simTime switchCost;			/* Ticks a CPU spends going from one process to another */
+	const schedPolicy *policy;	/* ALGO_POLICY: hooks of the policy, without POLICY_ARRIVE_AT_ZERO */
+	const void *policyParams;	/* ALGO_POLICY: handed to its init */
+}schedParams;
+
+typedef struct {
+	procTable table;			/* Executed copy of the workload in scheduling order */
+	simTime totalTime;			/* Time at which last process finished */
+	double avgWaiting;			/* Mean of waitingTime, i.e. time till first run */
+	double avgTurnaround;
+	long long contextSwitches;	/* Times a CPU went from one process to another */
+	long long preemptions;		/* Switches away from a process that had not finished */
+	simTime idleTime;			/* Ticks CPUs had nothing to run, summed over CPUs */
+	simTime switchTime;			/* Ticks CPUs spent switching, summed over CPUs */
+	double avgQueue;			/* Mean number of ready processes waiting for a CPU */
+	int maxQueue;				/* Most processes ready at one scheduling decision */
+	long long migrations;		/* Times a process resumed on another CPU */
+	long long steals;			/* Processes taken from queue of another CPU */
+	int arrivalIsPriority;		/* arrivalTime of table holds priority (ALGO_PRIORITY) */
+	arena mem;					/* Holds the table */
+}schedResult;
+
+int sched_run(int, const workload *, const schedParams *, schedResult *);	/* 0 on success, -1 if out of memory or bad arguments */
+int sched_rerun(int, const workload *, const schedParams *, const schedResult *, schedResult *);	/* What-if run of a changed workload
+																									   resuming from checkpoints of previous result */
+void sched_result_free(schedResult *);									/* Releases table of a result */
+
+#endif /* SCHED_H_ */
@@ -15,45 +15,254 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <time.h>
+#include <dlfcn.h>
+#include "engine.h"
+#include "arena.h"
+#include "timeline.h"
+#include "workload.h"
+#include "sched.h"
+#include "stats.h"
+#include "sweep.h"
+#include "smp.h"
+#include "stream.h"
+#include "output.h"
+#include "replay.h"
+#include "profile.h"
 
 /**************Global Variable Declarations **********************************/
 
-static int currentTime=0;		/*This variable holds current time and increases as processes get executed*/
-int numOfProcesses;				/*variable to hold number of processes*/
-int currentRunningProcess;		/*Keeps track of current running process*/
-
-typedef struct {
-	char name[3];
-	int arrivalTime;
-	int burstTime;
-	int startTime;
-	int finishTime;
-	int waitingTime;
-	int IsActiveFor;
-}proc;
-
-typedef struct {
-	char name[3];
-}names;
+#define PROFILE_EVENTS (1 << 20)		/*Most events --profile-trace keeps*/
+
+static int batchMode=0;			/*Set by --batch: no prompts, no per-tick output, only final table and summary*/
+static double realtimeScale=-1;	/*Seconds slept per simulated tick. Zero means run at full CPU speed*/
+static const char *inputPath=NULL;	/*Trace given with --input ("-" for stdin) used instead of prompts*/
+static int numCpusArg=1;			/*Simulated CPUs given with --cpus*/
+static int balanceArg=BALANCE_GLOBAL;	/*Ready queues of several CPUs, set by --balance*/
+static simTime migrationCostArg=0;	/*Ticks lost by a process resuming on another CPU, set by --migration-cost*/
+static simTime switchCostArg=0;		/*Ticks lost by a CPU going from one process to another, set by --switch-cost*/
+static int formatArg=OUT_TEXT;		/*Report format of --batch, set by --format*/
+static int verbosityArg=VERBOSITY_PROCESSES;	/*What --batch reports, set by --verbosity*/
+static const char *outputPath=NULL;	/*Report file of --batch given with --output, stdout otherwise*/
+static simTime ganttFrom=0;			/*Window of Gantt chart given with --gantt, whole chart when ganttColumns is 0*/
+static simTime ganttTo=-1;			/*End of window, -1 for end of run*/
+static int ganttColumns=0;			/*Columns of the window*/
+static const schedPolicy *policyArg=NULL;	/*Policy loaded by --policy-lib, run by --batch policy*/
+static int profileArg=0;			/*Set by --profile: print time per phase and counters at exit*/
+static const char *profileTracePath=NULL;	/*Chrome trace written at exit, given with --profile-trace*/
+static int profileSampleArg=100;	/*Dispatches per traced one, set by --profile-sample*/
 
 /**************Function Declarations **********************************/
 
-void psort(proc *, int);			/* Sorts Processes according to Burst Time */
-int selectProcess(proc *);			/* Selects the process having shortest burst time */
-void execProcess(proc *, int, names *);		/* Executes process got from selectProcess() */
-int getTotalBurstTime(proc *, int);        /* Calculates total burst Time */
-void fcfs(proc *, names *);			/*Declaration for FCFS function*/
-void sjfp(proc *, names *);			/*Declaration for SJFP function*/
-void priority(proc *, names *);		/*Declaration for Priority Based function*/
-void prioSort(proc *, int);			/*Declaration for sorting according to highest priority function*/
-void roundrobin(proc *, names *);  	/*Declaration for Round Robin function*/
+simTime getTotalBurstTime(const procTable *);    /* Calculates total burst Time */
+void runWorkload(int, workload *, arena *);	/*Runs one algorithm on a workload and prints its tables and Gantt chart*/
+void prompt(const char *, ...);		/*Prints input prompts in interactive mode only*/
+int animating(void);				/*Tells whether per-tick output and delay are enabled*/
+void tickDelay(void);				/*Sleeps for one simulated tick scaled by realtimeScale*/
+int readWorkload(arena *, workload *, int);	/*Reads processes interactively into a workload*/
+int getWorkload(arena *, workload *, int);	/*Loads --input trace or reads processes interactively*/
+void runAlgorithm(int);				/*Loads workload, runs one algorithm on it and releases the run*/
+timeline *newTimeline(arena *, timeline *, int);	/*Creates Gantt chart timeline inside run arena*/
+void printGantt(const timeline *, int, const procTable *, simTime);	/*Prints Gantt chart, or its --gantt window*/
+int parseGantt(const char *);		/*Parses FROM:[TO][:COLUMNS] of --gantt*/
+void showRun(const procTable *, int, simTime, simTime, void *);	/*Animates and records one run of the CPU for Gantt chart*/
+void showCpuRun(const procTable *, int, int, simTime, simTime, void *);	/*Same as showRun for one CPU of several*/
+void setCpus(schedParams *);		/*Applies --cpus, --balance, --migration-cost and --switch-cost to a run*/
+void printCpus(const schedResult *);	/*Prints migrations and steals of a run on several CPUs*/
+void printCounters(const schedResult *);	/*Prints preemptions, idle and switch time and ready queue with --switch-cost*/
+int parseBalance(const char *);		/*Parses balancing given with --balance*/
+int parseQuanta(const char *, mlfqParams *);	/*Parses quanta of --mlfq-quanta*/
+int loadPolicy(const char *);		/*Loads the policy of --policy-lib*/
+void printSummary(const procTable *, simTime, int);	/*Prints average waiting and turnaround time*/
+void printMetric(const char *, const metricSummary *);	/*Prints one row of statistics table*/
+void usage(const char *);			/*Prints command line help*/
+int parseSweep(const char *, sweepSpec *);	/*Parses MIN:MAX[:STEP] of --sweep*/
+int sweepMode(const sweepSpec *);		/*Runs --sweep on the --input trace and prints its table*/
+int streamMode(int);					/*Runs --stream on the --input trace, printing processes as they finish*/
+void printDone(const streamJob *, void *);	/*Prints one finished process of --stream*/
+int whatIfMode(int, const char *);		/*Runs --input trace with checkpoints, then the --what-if trace from them*/
+int reportMode(int);					/*Runs --batch writing a --format/--verbosity report*/
+int replayMode(int, const char *, int);	/*Runs --batch on every trace of the --replay directory and prints the fleet*/
+void reportSegment(const procTable *, int, simTime, simTime, void *);	/*Writes one run of the CPU to the report*/
+void reportCpuSegment(const procTable *, int, int, simTime, simTime, void *);	/*Same for one CPU of several*/
+int startProfiling(void);			/*Turns on profiling asked for by --profile or --profile-trace*/
+void stopProfiling(void);			/*Prints profile and writes trace, run at exit*/
+
+static simTime timeQuantaArg = 0;		/*Time quantum given with --quantum, used by Round Robin instead of asking*/
+static simTime agingArg = 0;			/*Ticks per priority level gained while waiting, given with --aging*/
+static mlfqParams mlfqArg = { 3, { 2, 4, 8 }, 0 };	/*Levels and quanta of --mlfq-quanta, boost of --boost*/
+static cfsParams cfsArg = { 24, 3 };	/*Period of --sched-latency and shortest slice of --min-granularity*/
+static simTime checkpointArg = 1000;	/*Ticks between checkpoints of --what-if, set by --checkpoint-interval*/
 
 /**************Main starts here **********************************/
 
-int main(void) {
-	proc process[10];
-	names pnames[10];
-	int choice;
+int main(int argc, char *argv[]) {
+	arena runArena;
+	workload wl;
+	int choice, i, algoChoice = 0, ret, sweep = 0, stream = 0;
+	const char *algo = NULL, *savePath = NULL, *whatIfPath = NULL, *replayDir = NULL, *policyPath = NULL;
+	sweepSpec spec = {0};
+
+	/*Parse command line. Without arguments the interactive menu is shown as before*/
+	for(i=1; i<argc; i++) {
+		if(strcmp(argv[i], "--batch") == 0 && i+1 < argc) {
+			batchMode = 1;
+			algo = argv[++i];
+		} else if(strcmp(argv[i], "--quantum") == 0 && i+1 < argc) {
+			timeQuantaArg = atoll(argv[++i]);
+		} else if(strcmp(argv[i], "--aging") == 0 && i+1 < argc && atoll(argv[i+1]) >= 0) {
+			agingArg = atoll(argv[++i]);
+		} else if(strcmp(argv[i], "--mlfq-quanta") == 0 && i+1 < argc && parseQuanta(argv[i+1], &mlfqArg) == 0) {
+			i++;
+		} else if(strcmp(argv[i], "--boost") == 0 && i+1 < argc && atoll(argv[i+1]) >= 0) {
+			mlfqArg.boostInterval = atoll(argv[++i]);
+		} else if(strcmp(argv[i], "--sched-latency") == 0 && i+1 < argc && atoll(argv[i+1]) > 0) {
+			cfsArg.latency = atoll(argv[++i]);
+		} else if(strcmp(argv[i], "--min-granularity") == 0 && i+1 < argc && atoll(argv[i+1]) > 0) {
+			cfsArg.minGranularity = atoll(argv[++i]);
+		} else if(strcmp(argv[i], "--realtime-scale") == 0 && i+1 < argc) {
+			realtimeScale = atof(argv[++i]);
+		} else if(strcmp(argv[i], "--input") == 0 && i+1 < argc) {
+			inputPath = argv[++i];
+		} else if(strcmp(argv[i], "--save-trace") == 0 && i+1 < argc) {
+			savePath = argv[++i];
+		} else if(strcmp(argv[i], "--sweep") == 0 && i+1 < argc && parseSweep(argv[i+1], &spec) == 0) {
+			sweep = 1;
+			i++;
+		} else if(strcmp(argv[i], "--what-if") == 0 && i+1 < argc) {
+			whatIfPath = argv[++i];
+		} else if(strcmp(argv[i], "--gantt") == 0 && i+1 < argc && parseGantt(argv[i+1]) == 0) {
+			i++;
+		} else if(strcmp(argv[i], "--replay") == 0 && i+1 < argc) {
+			replayDir = argv[++i];
+		} else if(strcmp(argv[i], "--policy-lib") == 0 && i+1 < argc) {
+			policyPath = argv[++i];
+		} else if(strcmp(argv[i], "--checkpoint-interval") == 0 && i+1 < argc && atoll(argv[i+1]) > 0) {
+			checkpointArg = atoll(argv[++i]);
+		} else if(strcmp(argv[i], "--format") == 0 && i+1 < argc && parseFormat(argv[i+1]) >= 0) {
+			formatArg = parseFormat(argv[++i]);
+		} else if(strcmp(argv[i], "--verbosity") == 0 && i+1 < argc && parseVerbosity(argv[i+1]) >= 0) {
+			verbosityArg = parseVerbosity(argv[++i]);
+		} else if(strcmp(argv[i], "--output") == 0 && i+1 < argc) {
+			outputPath = argv[++i];
+		} else if(strcmp(argv[i], "--stream") == 0) {
+			stream = 1;
+		} else if(strcmp(argv[i], "--sweep-all") == 0) {
+			spec.allAlgorithms = 1;
+		} else if(strcmp(argv[i], "--threads") == 0 && i+1 < argc) {
+			spec.numThreads = atoi(argv[++i]);
+		} else if(strcmp(argv[i], "--cpus") == 0 && i+1 < argc && atoi(argv[i+1]) > 0) {
+			numCpusArg = atoi(argv[++i]);
+		} else if(strcmp(argv[i], "--balance") == 0 && i+1 < argc && parseBalance(argv[i+1]) >= 0) {
+			balanceArg = parseBalance(argv[++i]);
+		} else if(strcmp(argv[i], "--migration-cost") == 0 && i+1 < argc && atoll(argv[i+1]) >= 0) {
+			migrationCostArg = atoll(argv[++i]);
+		} else if(strcmp(argv[i], "--switch-cost") == 0 && i+1 < argc && atoll(argv[i+1]) >= 0) {
+			switchCostArg = atoll(argv[++i]);
+		} else if(strcmp(argv[i], "--profile") == 0) {
+			profileArg = 1;
+		} else if(strcmp(argv[i], "--profile-trace") == 0 && i+1 < argc) {
+			profileTracePath = argv[++i];
+		} else if(strcmp(argv[i], "--profile-sample") == 0 && i+1 < argc && atoi(argv[i+1]) >= 0) {
+			profileSampleArg = atoi(argv[++i]);
+		} else {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	/*Streaming, what-if and replay runs use the algorithm of --batch, there is no menu to pick one from*/
+	if((stream || whatIfPath || replayDir) && !batchMode) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	/*Batch mode runs at full speed unless --realtime-scale asks for the animated demo*/
+	if(realtimeScale < 0) {
+		realtimeScale = batchMode ? 0 : 1;
+	}
+	if((profileArg || profileTracePath) && startProfiling() != 0) {
+		return EXIT_FAILURE;
+	}
+
+	/*Convert a trace to binary format and quit*/
+	if(savePath) {
+		if(inputPath == NULL) {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		ret = loadWorkload(inputPath, &runArena, 0, &wl) == 0 && saveBinaryWorkload(savePath, &wl) == 0;
+		freeWorkload(&wl);
+		arenaFree(&runArena);
+		return ret ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if(sweep) {
+		batchMode = 1;
+		spec.numCpus = numCpusArg;
+		spec.balance = balanceArg;
+		spec.migrationCost = migrationCostArg;
+		spec.switchCost = switchCostArg;
+		return sweepMode(&spec) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if(batchMode) {
+		if(inputPath == NULL) {
+			inputPath = "-";
+		}
+		if(strcmp(algo, "fcfs") == 0 || strcmp(algo, "1") == 0) {
+			algoChoice = ALGO_FCFS;
+		} else if(strcmp(algo, "sjfp") == 0 || strcmp(algo, "2") == 0) {
+			algoChoice = ALGO_SJFP;
+		} else if(strcmp(algo, "priority") == 0 || strcmp(algo, "3") == 0) {
+			algoChoice = ALGO_PRIORITY;
+		} else if(strcmp(algo, "rr") == 0 || strcmp(algo, "4") == 0) {
+			if(timeQuantaArg <= 0) {
+				fprintf(stderr, "Round Robin needs a positive --quantum\n");
+				return EXIT_FAILURE;
+			}
+			algoChoice = ALGO_RR;
+		} else if(strcmp(algo, "ppriority") == 0) {
+			algoChoice = ALGO_PRIORITY_PREEMPTIVE;
+		} else if(strcmp(algo, "mlfq") == 0) {
+			algoChoice = ALGO_MLFQ;
+		} else if(strcmp(algo, "cfs") == 0 || strcmp(algo, "5") == 0) {
+			algoChoice = ALGO_CFS;
+		} else if(strcmp(algo, "policy") == 0 && policyPath) {
+			if(loadPolicy(policyPath) != 0) {
+				return EXIT_FAILURE;
+			}
+			algoChoice = ALGO_POLICY;
+		} else {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		if(algoChoice == ALGO_POLICY && (numCpusArg > 1 || stream)) {
+			fprintf(stderr, "A policy of --policy-lib runs on one CPU, --cpus and --stream cannot be used\n");
+			return EXIT_FAILURE;
+		}
+		if(numCpusArg > 1 && algoChoice > ALGO_RR) {
+			fprintf(stderr, "--cpus only runs fcfs, sjfp, priority and rr\n");
+			return EXIT_FAILURE;
+		}
+		if(stream) {
+			return streamMode(algoChoice) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		if(whatIfPath) {
+			return whatIfMode(algoChoice, whatIfPath) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		if(replayDir) {
+			return replayMode(algoChoice, replayDir, spec.numThreads) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		/*Tables of the algorithm functions stay the default report, a loaded policy has none*/
+		if(formatArg != OUT_TEXT || verbosityArg != VERBOSITY_PROCESSES || outputPath || algoChoice == ALGO_POLICY) {
+			return reportMode(algoChoice) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		runAlgorithm(algoChoice);
+		return EXIT_SUCCESS;
+	}
 
 	do{
 	        printf("\n\n\t\t\t*MENU*\n");
@@ -62,30 +271,34 @@ int main(void) {
 	                2. Shortest Job First (Preemptive)\n \
 	                3. Priority Based (Non-Preemptive)\n \
 	                4. Round Robin \n \
-	                5. EXIT \n \
+	                5. Completely Fair Scheduler \n \
+	                6. EXIT \n \
 	                ");
 	        printf("Enter your choice: ");
 	        scanf("%d", &choice);
 	        switch(choice) {
 	            case 1:
-	                fcfs(process, pnames);
+	                runAlgorithm(ALGO_FCFS);
 	                break;
 	            case 2:
-	                sjfp(process, pnames);
+	                runAlgorithm(ALGO_SJFP);
 	                break;
 	            case 3:
-	                priority(process, pnames);
+	                runAlgorithm(ALGO_PRIORITY);
 	                break;
 	            case 4:
-	                roundrobin(process, pnames);
+	                runAlgorithm(ALGO_RR);
 	                break;
 	            case 5:
+	                runAlgorithm(ALGO_CFS);
+	                break;
+	            case 6:
 	                exit(0);
 	            default:
 	                printf("\nInvalid Choice\n");
 	                break;
 	        }
-	    }while(choice != '5');
+	    }while(choice != '6');
 
 
 
@@ -96,586 +309,956 @@ int main(void) {
 /*********************** Function Definitions **********************************/
 
 /**
- * Function Name: 	psort
- * Function:		Sorts Process Array according arrivalTime in ascending order
- * Input:			Process Array, Total number of process
- * Output:			Sorted process array
- * Affects:			Destroys original process array
+ * Function Name:	getTotalBurstTime
+ * Function: 		Calculates total burst time by summing burst time of individual process from process array
+ * Input:			process table
+ * Output:			totalBurstTime
+ * Affects:			Nothing
  */
-void psort(proc pproc[], int numOfProcesses) {
-	int i, j, test;
-	proc temp;
-
-	for(i = numOfProcesses - 1; i > 0; i--) {
-		test = 0;
-		for(j=0; j < i; j++) {
-			if((pproc[j].arrivalTime) > (pproc[j+1].arrivalTime) ) {
-				temp = pproc[j];
-				pproc[j] = pproc[j+1];
-				pproc[j+1] = temp;
-				test=1;
-			}
-		}
-		if(test==0) break;
-	}
+
+simTime getTotalBurstTime(const procTable *pproc) {
+	return procTotalBurst(pproc);
 }
 
+/* Name and the columns before the burst of a row of the process tables: arrival time, or priority with
+   ALGO_PRIORITY, and priority too for the algorithms scheduling on both */
+static void printRowStart(const procTable *t, int i, simTime first, int showPriority, int wide) {
+	printf("\n%s\t%lld", PROC_NAME(t, i), first);
+	if(showPriority) {
+		printf("\t%d", t->priority[i]);
+	}
+	if(wide) {
+		printf("\t");
+	}
+}
 
 /**
- * Function Name: 	selectProcess
- * Function:		Selects the process having the smallest NON-ZERO burstTime from the currently arrived processes
- * Input:			CurrentTime(from global variable), Sorted process array
- * Output:			Index of Process having smallest burstTime from arrived processes
- * Affects:			Nothing
+ * Function Name: 	runWorkload
+ * Function: 		Runs one algorithm on a loaded workload, then prints the final table, the summary and the
+ * 					Gantt chart. Interactively the processes are listed first, and Round Robin asks for its
+ * 					quantum unless --quantum gave one
+ * Input: 			Algorithm (ALGO_FCFS .. ALGO_CFS), loaded workload, arena of the run for Gantt chart timeline
+ * Output:			None
+ * Affects:			Arena of the run
+ * NOTES:			With ALGO_PRIORITY the priority column replaces arrival time: every process arrives at 0
+ * 					and higher priority number runs first, unlike *nix where 0 is the highest. Preemptive
+ * 					Priority and CFS list priority next to arrival time; CFS takes it as nice = -priority, so
+ * 					processes read interactively all weigh the same.
  */
 
-int selectProcess(proc pproc[]) {
+void runWorkload(int algo, workload *wl, arena *runArena) {
+	procTable *process = &wl->table;
+	int numOfProcesses = process->numOfProcesses, i;
+	int byPriority = algo == ALGO_PRIORITY;
+	int showPriority = algo == ALGO_PRIORITY_PREEMPTIVE || algo == ALGO_CFS;
+	int wide = byPriority || showPriority;		/*Priority columns are two tabs wide*/
+	timeline chart, *pchart = NULL;
+	schedParams params = { 0, 0, showRun, NULL };
+	schedResult run;
+	simTime totalServiceTime, currentTime;
+
+	params.quantum = timeQuantaArg;
+	if(algo == ALGO_RR && timeQuantaArg <= 0) {
+		printf("Enter Time Quanta: ");
+		scanf("%lld", &params.quantum);
+	}
 
-	int i=0, j, indexOfleastProcessTime, minBurstTime;
-	indexOfleastProcessTime = -1;
+	if(!batchMode) {
+		printf("\n\nPName\t%s%s\tBTime\n", byPriority ? "Priority" : "ArrTime", showPriority ? "\tPriority" : "");
 
-	while ( pproc[i].arrivalTime <= currentTime && i < numOfProcesses) {
-		i++; 									/* Find array of arrived processes*/
+		for(i=0; i<numOfProcesses; i++) {
+			printRowStart(process, i, byPriority && wl->hasPriority ? process->priority[i] : process->arrivalTime[i],
+					showPriority, wide);
+			printf("\t%lld", process->burstTime[i]);
+		}
 	}
 
-	i--;		/*since array index starts from zero and we already incremented 'i' in while loop we have to decrement so that we don't cross currentTime*/
-
-	for(j=0; j <= i && pproc[j].burstTime == 0; j++); /* Find first non-zero value in array*/
+	if(!batchMode) puts("\n");
 
-	/* Finding index of minimum burstTime */
-	minBurstTime = pproc[j].burstTime;
-	indexOfleastProcessTime = j;
+	totalServiceTime = getTotalBurstTime(process);
+	if(!batchMode) printf("\nTotal Burst Time: %lld \n", totalServiceTime );
 
-	while(j<=i) {
-		if(pproc[j].burstTime != 0 && pproc[j].burstTime < minBurstTime) {
-			minBurstTime = pproc[j].burstTime;
-			indexOfleastProcessTime = j;
-		}
-		j++;
+	if(!batchMode || ganttColumns) {
+		pchart = newTimeline(runArena, &chart, numOfProcesses);
+	}
+	params.arg = pchart;
+	params.agingInterval = agingArg;
+	params.mlfq = mlfqArg;
+	params.cfs = cfsArg;
+	setCpus(&params);
+	if(sched_run(algo, wl, &params, &run) != 0) {
+		fprintf(stderr, "Not enough memory to run processes, time quanta is not positive or algorithm cannot run "
+				"on several CPUs\n");
+		sched_result_free(&run);
+		return;
 	}
+	process = &run.table;	/*Executed copy, in scheduling order*/
+	currentTime = run.totalTime;
+
+	printf("\n\nPName\t%s%s\tBTime\tSTime\tFTime\tWTime\tTATime\n", byPriority ? "Priority" : "ArrTime",
+			showPriority ? "\tPriority" : "");
 
-	/*Keep record of startTime*/
-	if(indexOfleastProcessTime == 0 && pproc[indexOfleastProcessTime].startTime == 0) {
-		pproc[indexOfleastProcessTime].startTime = 0;
-	} else if(pproc[indexOfleastProcessTime].startTime == 0) {
-		pproc[indexOfleastProcessTime].startTime = currentTime;
+	/*Display final table*/
+	for(i=0; i<numOfProcesses; i++) {
+		printRowStart(process, i, process->arrivalTime[i], showPriority, wide);
+		printf("\t%lld\t%lld\t%lld\t%lld\t%lld", process->IsActiveFor[i], process->startTime[i], process->finishTime[i],
+				process->waitingTime[i], process->finishTime[i] - (run.arrivalIsPriority ? 0 : process->arrivalTime[i]));
 	}
 
-	currentRunningProcess = indexOfleastProcessTime; /*This is not needed now but you may use it while animating Gantt Chart*/
+	printSummary(process, currentTime, run.arrivalIsPriority);
+	printCpus(&run);
+	printCounters(&run);
 
-	return indexOfleastProcessTime;
+	printf("\n\nAll Processes executed...\n\n");
+
+	/*Gantt chart is not recorded in batch mode unless --gantt asks for it*/
+	if(pchart) {
+		printGantt(pchart, numCpusArg, process, currentTime);
+	}
+	sched_result_free(&run);
 }
 
 /**
- * Function Name: 	execProcess
- * Function: 		Executes process returned by the selectProcess function
- * Input: 			Sorted process Array, totalBurstTIme, another process array for storing sequence of executed processes
- * Output:			Status of executing process
- * Affects:			currentTime, burstTime of process under execution
+ * Function Name: 	prompt
+ * Function: 		Prints an input prompt. Prompts are suppressed in batch mode so that workload can be piped in
+ * Input: 			printf style format and arguments
+ * Output:			None
+ * Affects:			Nothing
  */
-void execProcess(proc pproc[], int totalBurstTime, names pnames[]) {
-	int indexOfleastProcessTime, i=0;
-
-	while (currentTime != totalBurstTime) { /*Terminating Condition*/
-		printf("\n\nFetching next Shortest Process...\n");
 
-		indexOfleastProcessTime = selectProcess(pproc); /* Call to process selection function */
+void prompt(const char *fmt, ...) {
+	va_list ap;
 
-		printf("\nExecuting Process %s \n", pproc[indexOfleastProcessTime].name);
+	if(batchMode) {
+		return;
+	}
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+}
 
-		pproc[indexOfleastProcessTime].burstTime -= 1;
-		pproc[indexOfleastProcessTime].IsActiveFor += 1;
+/**
+ * Function Name: 	animating
+ * Function: 		Tells whether per tick messages and delay are wanted i.e. interactive mode or --realtime-scale in batch mode
+ * Input: 			None
+ * Output:			1 if animating, 0 otherwise
+ * Affects:			Nothing
+ */
 
-		/*Stores finish time if current process gets totally executed i.e. burstTime becomes zero and also calculates waiting time*/
-		if(pproc[indexOfleastProcessTime].burstTime == 0){
+int animating(void) {
+	return !batchMode || realtimeScale > 0;
+}
 
-			pproc[indexOfleastProcessTime].finishTime = currentTime+1;
-/*
- * 		This waiting time is total waiting time. It means that idle time spent by the process since it has arrived
- * 		pproc[indexOfleastProcessTime].waitingTime = pproc[indexOfleastProcessTime].finishTime-pproc[indexOfleastProcessTime].IsActiveFor-pproc[indexOfleastProcessTime].startTime;
- *
+/**
+ * Function Name: 	tickDelay
+ * Function: 		Sleeps for one simulated tick. Replaces system("sleep 1") which forked a shell for every tick
+ * Input: 			realtimeScale(from global variable)
+ * Output:			None
+ * Affects:			Nothing
  */
 
-			pproc[indexOfleastProcessTime].waitingTime = pproc[indexOfleastProcessTime].startTime - pproc[indexOfleastProcessTime].arrivalTime ;
-            /*Handle if no process arrives at time 0*/
-            if(pproc[indexOfleastProcessTime].waitingTime < 0) {
-                pproc[indexOfleastProcessTime].waitingTime =0;
-            }
-		}
+void tickDelay(void) {
+	struct timespec ts;
 
-		system("sleep 1"); 				/*Get the feeling of process being executed :) (Same as delay() function in Windows)*/
-		strcpy(pnames[i].name, pproc[indexOfleastProcessTime].name); /*Store the process name to display in chart*/
-		i++;
-		currentTime += 1;
+	if(realtimeScale <= 0) {
+		return;
 	}
-
+	ts.tv_sec = (time_t)realtimeScale;
+	ts.tv_nsec = (long)((realtimeScale - ts.tv_sec) * 1e9);
+	nanosleep(&ts, NULL);
 }
 
 /**
- * Function Name:	getTotalBurstTime
- * Function: 		Calculates total burst time by summing burst time of individual process from process array
- * Input:			process array
- * Output:			totalBurstTime
- * Affects:			Nothing
+ * Function Name: 	readWorkload
+ * Function: 		Asks for processes one by one. Arena of the run is sized from the number of processes
+ * 					so that process table, names and Gantt chart need one allocation
+ * Input: 			Arena of the run, workload to fill, flag telling priority is asked instead of arrival time
+ * Output:			0 on success, -1 on invalid input or when out of memory
+ * Affects:			Arena, workload
  */
 
-int getTotalBurstTime(proc pproc[], int numOfProcesses) {
-	int i, sum = 0;
-	for(i=0; i< numOfProcesses; i++) {
-		sum += pproc[i].burstTime;
+int readWorkload(arena *runArena, workload *wl, int askPriority) {
+	procTable *t = &wl->table;
+	stringTable names;
+	char name[64];
+	long offset;
+	int i, n;
+
+	memset(wl, 0, sizeof(*wl));
+	runArena->current = NULL;
+	prompt("Enter Number of Processes: \n");
+	/*Names of all of them must stay at offsets the table can hold*/
+	if(scanf("%d", &n) != 1 || n <= 0 || (size_t)n > UINT_MAX / sizeof(name)) {
+		fprintf(stderr, "Number of processes must be between 1 and %zu\n", UINT_MAX / sizeof(name));
+		return -1;
+	}
+	if(arenaInit(runArena, (size_t)n * (PROC_TABLE_BYTES + sizeof(name) / 4 + 3 * sizeof(segment))) != 0 ||
+			procTableInit(t, runArena, n) != 0 || stringTableInit(&names, runArena, (size_t)n * sizeof(name) / 4) != 0) {
+		fprintf(stderr, "Not enough memory for %d processes\n", n);
+		return -1;
 	}
-	return sum;
+	wl->hasPriority = askPriority;
 
+	for(i=0; i<n; i++) {
+		prompt("Enter Process Name: ");
+		if(scanf("%63s", name) != 1 || (offset = intern(&names, name)) < 0) {
+			return -1;
+		}
+		t->name[i] = (unsigned)offset;
+		if(askPriority) {
+			prompt("Enter Priority for Process %s: ", name);
+			if(scanf("%d", &t->priority[i]) != 1) {
+				return -1;
+			}
+		} else {
+			prompt("Enter Arrival Time for Process %s: ", name);
+			if(scanf("%lld", &t->arrivalTime[i]) != 1) {
+				return -1;
+			}
+		}
+		prompt("Enter Burst Time for Process %s: ", name);
+		if(scanf("%lld", &t->burstTime[i]) != 1) {
+			return -1;
+		}
+	}
+	t->strings = names.buf;
+	t->stringsSize = names.used;
+	return 0;
 }
 
 /**
- * Function Name: 	sjfp
- * Function: 		To perform Shortest Job First Pre-emptive algorithm
- * Input: 			Process Array, another process array for storing sequence of executed processes
- * Output:			None
- * Affects:			currentTime, process array structure, sequencing structure i.e. pnames
+ * Function Name: 	getWorkload
+ * Function: 		Loads trace given with --input, otherwise reads processes interactively
+ * Input: 			Arena of the run, workload to fill, flag telling priority is asked instead of arrival time
+ * Output:			0 on success, -1 on error (message already printed)
+ * Affects:			Arena, workload
  */
 
-void sjfp(proc process[], names pnames[]) {
-
-		int i, totalServiceTime;
-		currentTime = 0;
-		puts("Shortest Job First Pre-emptive Algorithm\n");
-		puts("Enter Number of Processes: ");
-		scanf("%d", &numOfProcesses);
-
-		for(i=0; i<numOfProcesses; i++) {
-			printf("Enter Process Name(Max 2 chars): ");
-			scanf("%s", process[i].name);
-			printf("Enter Arrival Time for Process %s: ", process[i].name);
-			scanf("%d", &process[i].arrivalTime);
-			printf("Enter Burst Time for Process %s: ", process[i].name);
-			scanf("%d", &process[i].burstTime);
-
-			/* Initialise other properties accordingly*/
-			process[i].startTime = 0;
-			process[i].waitingTime = 0;
-			process[i].IsActiveFor = 0;
+int getWorkload(arena *runArena, workload *wl, int askPriority) {
+	int ret;
 
+	if(inputPath) {
+		if(loadWorkload(inputPath, runArena, batchMode ? 0 : 3 * sizeof(segment), wl) != 0) {
+			return -1;
 		}
-
-		printf("\n\nPName\tArrTime\tBTime\n");
-
-		for(i=0; i<numOfProcesses; i++) {
-			printf("\n%s\t%d\t%d", process[i].name, process[i].arrivalTime, process[i].burstTime);
+		if(wl->table.ioLeft && numCpusArg > 1) {
+			fprintf(stderr, "I/O bursts are only simulated on one CPU\n");
+			return -1;
 		}
+		return 0;
+	}
+	PROF_BEGIN(PROF_LOAD);
+	ret = readWorkload(runArena, wl, askPriority);
+	PROF_END(PROF_LOAD);
+	return ret;
+}
 
-		psort(process, numOfProcesses);
-		puts("\n");
-
-		totalServiceTime = getTotalBurstTime(process, numOfProcesses);
-		printf("\nTotal Burst Time: %d \n", totalServiceTime );
+/**
+ * Function Name: 	runAlgorithm
+ * Function: 		Gets the workload, runs selected algorithm on it and releases everything used by the run
+ * Input: 			Algorithm (ALGO_FCFS .. ALGO_CFS)
+ * Output:			None
+ * Affects:			Nothing
+ */
 
-	    execProcess(process, getTotalBurstTime(process, numOfProcesses ), pnames);
+void runAlgorithm(int algo) {
+	static const char *title[] = { "", "\n\t\t\tFirst Come First Serve Algorithm\n",
+			"Shortest Job First Pre-emptive Algorithm\n", "Priority Based (Non-Preemptive) Algorithm\n",
+			"Round Robin Algorithm\n", "Priority Based (Preemptive) Algorithm\n",
+			"Multilevel Feedback Queue Algorithm\n", "Completely Fair Scheduler Algorithm\n" };
+	arena runArena;
+	workload wl;
+
+	if(!batchMode) puts(title[algo]);
+	if(getWorkload(&runArena, &wl, algo == ALGO_PRIORITY) == 0) {
+		runWorkload(algo, &wl, &runArena);
+	}
+	freeWorkload(&wl);
+	arenaFree(&runArena);
+}
 
-	    printf("\n\nPName\tArrTime\tBTime\tSTime\tFTime\tWTime\tTATime\n");
+/**
+ * Function Name: 	newTimeline
+ * Function: 		Creates Gantt chart timeline inside arena of the run. Room is reserved for two segments per process
+ * 					which covers every algorithm except Round Robin, which grows it as needed. With --cpus every
+ * 					CPU gets a lane of its own, allocated next to each other in the arena
+ * Input: 			Arena of the run, timeline to initialise, number of processes
+ * Output:			Timeline (first lane), NULL when out of memory (chart is then not recorded)
+ * Affects:			Arena
+ */
 
+timeline *newTimeline(arena *runArena, timeline *chart, int numOfProcesses) {
+	int c;
 
-		/*Display final table*/
-		for(i=0; i<numOfProcesses; i++) {
-			printf("\n%s\t%d\t%d\t%d\t%d\t%d\t%d", process[i].name, process[i].arrivalTime, process[i].IsActiveFor,
-					process[i].startTime, process[i].finishTime, process[i].waitingTime, process[i].finishTime - process[i].arrivalTime);
+	if(numCpusArg > 1 && (chart = arenaAlloc(runArena, numCpusArg * sizeof(timeline))) == NULL) {
+		fprintf(stderr, "Not enough memory for Gantt chart\n");
+		return NULL;
+	}
+	for(c=0; c<numCpusArg; c++) {
+		if(timelineInit(&chart[c], runArena, (2 * numOfProcesses + 1) / numCpusArg + 1) != 0) {
+			fprintf(stderr, "Not enough memory for Gantt chart\n");
+			return NULL;
 		}
+	}
+	return chart;
+}
 
+/* Whole Gantt chart as before, or the window given with --gantt ending at the end of the run at most */
+void printGantt(const timeline *lanes, int numCpus, const procTable *t, simTime totalTime) {
+	simTime to = ganttTo < 0 || ganttTo > totalTime ? totalTime : ganttTo;
 
-		printf("\n\nAll Processes executed...\n\n");
+	if(ganttColumns == 0) {
+		timelinePrintLanes(lanes, numCpus, t);
+	} else if(ganttFrom >= to) {
+		fprintf(stderr, "Gantt chart window starts after the run ended at %lld\n", totalTime);
+	} else if(timelinePrintWindow(lanes, numCpus, t, ganttFrom, to, ganttColumns) != 0) {
+		fprintf(stderr, "Not enough memory for Gantt chart\n");
+	}
+}
 
-		printf("Gantt Chart:\n");
+/**
+ * Function Name: 	showRun
+ * Function: 		Called by simulate() for every run of the CPU. Prints per tick messages with delay when animating
+ * 					and records the run in Gantt chart timeline
+ * Input: 			Process table, index of process being executed (IDLE_PROCESS when idle), start time, length of run, timeline
+ * Output:			None
+ * Affects:			Timeline
+ */
 
-	    /**
-	     * Displaying time axis
-	     * NOTE: This is not generic for loop. YOU HAVE TO ADJUST value of i, and font size of terminal accordingly to get proper view in line
-	     */
-	    for(i=0; i<=currentTime; i++) {
-	        printf("|%2d ",i);
-	    }
-	    printf("\n");
+void showRun(const procTable *pproc, int running, simTime start, simTime length, void *arg) {
+	timeline *chart = arg;
+	simTime t;
 
-	    /*Display processes sequentially*/
-		for(i=0; i<currentTime; i++) {
-			printf("|%s  ", pnames[i].name );
+	if(chart && timelineAppend(chart, running, start, length) != 0) {
+		fprintf(stderr, "Not enough memory for Gantt chart\n");
+	}
+	if(!animating()) {
+		return;
+	}
+	for(t=start; t<start+length; t++) {
+		if(running == SWITCHING_PROCESS) {
+			printf("\nSwitching process...\n");
+		} else if(running != IDLE_PROCESS) {
+			printf("\nFetching next Process...\n");
+			printf("\nExecuting process %s ...\n", PROC_NAME(pproc, running));
+		} else {
+			printf("\nNo Process is being executed..\n");
 		}
-		printf("|\n");
+		tickDelay();
+	}
 }
 
-
 /**
- * Function Name: 	fcfs
- * Function: 		To perform First Come First Serve algorithm
- * Input: 			Process Array, another process array for storing sequence of executed processes
+ * Function Name: 	showCpuRun
+ * Function: 		Called by simulateSmp() for every run of every CPU. Records the run in the lane of the CPU
+ * 					and prints one message per run when animating
+ * Input: 			Process table, CPU, index of process (IDLE_PROCESS or MIGRATING_PROCESS), start time, length of run, lanes
  * Output:			None
- * Affects:			currentTime, process array structure, sequencing structure i.e. pnames
+ * Affects:			Timeline of the CPU
  */
 
-void fcfs(proc process[], names pnames[]) {
-	int i, totalServiceTime;
-	currentTime = 0;
-	puts("\n\t\t\tFirst Come First Serve Algorithm\n");
-	puts("Enter Number of Processes: ");
-	scanf("%d", &numOfProcesses);
-
-	for(i=0; i<numOfProcesses; i++) {
-		printf("Enter Process Name(Max 2 chars): ");
-		scanf("%s", process[i].name);
-		printf("Enter Arrival Time for Process %s: ", process[i].name);
-		scanf("%d", &process[i].arrivalTime);
-		printf("Enter Burst Time for Process %s: ", process[i].name);
-		scanf("%d", &process[i].burstTime);
-
-		/* Initialise other properties accordingly*/
-		process[i].startTime = 0;
-		process[i].waitingTime = 0;
-		process[i].IsActiveFor = 0;
+void showCpuRun(const procTable *pproc, int cpu, int running, simTime start, simTime length, void *arg) {
+	timeline *lanes = arg;
 
+	if(lanes && timelineAppend(&lanes[cpu], running, start, length) != 0) {
+		fprintf(stderr, "Not enough memory for Gantt chart\n");
 	}
-
-	printf("\n\nPName\tArrTime\tBTime\n");
-
-	for(i=0; i<numOfProcesses; i++) {
-		printf("\n%s\t%d\t%d", process[i].name, process[i].arrivalTime, process[i].burstTime);
+	if(!animating()) {
+		return;
 	}
-
-	psort(process, numOfProcesses); /*To sort process array according to arrival time*/
-	puts("\n");
-
-	totalServiceTime = getTotalBurstTime(process, numOfProcesses);
-	printf("\nTotal Burst Time: %d \n", totalServiceTime );
-
-	for (i=0; i<numOfProcesses; i++) {
-		for(; process[i].burstTime > 0; process[i].burstTime -= 1) {
-			printf("\nFetching next Process...\n");
-			printf("\nExecuting Process %s ...\n", process[i].name);
-			strcpy(pnames[currentTime].name, process[i].name);
-			system("sleep 1");
-			process[i].IsActiveFor += 1;
-			currentTime +=1;
-		}
-		process[i].finishTime = currentTime;
-		process[i+1].startTime = currentTime;
-		process[i].waitingTime = process[i].startTime - process[i].arrivalTime;
-
+	if(running >= 0) {
+		printf("\nCPU %d executed process %s from %lld to %lld\n", cpu, PROC_NAME(pproc, running), start, start + length);
+	} else if(running == MIGRATING_PROCESS) {
+		printf("\nCPU %d migrating process from %lld to %lld\n", cpu, start, start + length);
+	} else if(running == SWITCHING_PROCESS) {
+		printf("\nCPU %d switching process from %lld to %lld\n", cpu, start, start + length);
 	}
+	tickDelay();
+}
 
+/**
+ * Function Name: 	setCpus
+ * Function: 		Applies --cpus, --balance, --migration-cost and --switch-cost to parameters of a run. Gantt chart
+ * 					lanes created by newTimeline() are recorded by showCpuRun
+ * Input: 			Parameters of the run
+ * Output:			None
+ * Affects:			Parameters
+ */
 
-	printf("\n\nPName\tArrTime\tBTime\tSTime\tFTime\tWTime\tTATime\n");
-
+void setCpus(schedParams *params) {
+	params->numCpus = numCpusArg;
+	params->balance = balanceArg;
+	params->migrationCost = migrationCostArg;
+	params->switchCost = switchCostArg;
+	params->onCpuRun = showCpuRun;
+}
 
-	/*Display final table*/
-	for(i=0; i<numOfProcesses; i++) {
-		printf("\n%s\t%d\t%d\t%d\t%d\t%d\t%d", process[i].name, process[i].arrivalTime, process[i].IsActiveFor,
-				process[i].startTime, process[i].finishTime, process[i].waitingTime, process[i].finishTime - process[i].arrivalTime);
+/* Counters of a run on several CPUs, nothing for one CPU */
+void printCpus(const schedResult *run) {
+	if(numCpusArg > 1) {
+		printf("\nCPUs: %d, Migrations: %lld, Steals: %lld", numCpusArg, run->migrations, run->steals);
 	}
+}
 
+/* Counters kept by the engine, only when switching costs something so that default output stays as it was */
+void printCounters(const schedResult *run) {
+	if(switchCostArg > 0) {
+		printf("\nContext Switches: %lld, Preemptions: %lld, Switch Time: %lld, Idle Time: %lld", run->contextSwitches,
+				run->preemptions, run->switchTime, run->idleTime);
+		printf("\nReady Queue: %.2f mean, %d max", run->avgQueue, run->maxQueue);
+	}
+}
 
-	printf("\n\nAll Processes executed...\n\n");
-
-	printf("Gantt Chart:\n");
+/**
+ * Function Name: 	printSummary
+ * Function: 		Prints average waiting and turnaround time of executed processes followed by
+ * 					percentiles of ready wait, turnaround and response time, throughput and CPU utilization
+ * 					(mean of all CPUs with --cpus)
+ * Input: 			Process table, time at which run ended, flag telling arrivalTime holds priority (all processes arrive at 0)
+ * Output:			None
+ * Affects:			Nothing
+ */
 
-    /**
-     * Displaying time axis
-     * NOTE: This is not generic for loop. YOU HAVE TO ADJUST value of i, and font size of terminal accordingly to get proper view in line
-     */
-    for(i=0; i<=currentTime; i++) {
-        printf("|%2d ",i);
-    }
-    printf("\n");
+void printSummary(const procTable *pproc, simTime currentTime, int arrivalIsPriority) {
+	runStats st;
 
-    /*Display processes sequentially*/
-	for(i=0; i<currentTime; i++) {
-		printf("|%s  ", pnames[i].name );
+	if(pproc->numOfProcesses <= 0) {
+		return;
 	}
-	printf("|\n");
-
+	if(computeStats(pproc, currentTime, arrivalIsPriority, &st) != 0) {
+		fprintf(stderr, "Not enough memory for statistics\n");
+		return;
+	}
+	/*WTime of the table is time till first run, i.e. response time*/
+	printf("\n\nTotal Time: %lld", currentTime);
+	printf("\nAverage Waiting Time: %.2f", st.response.mean);
+	printf("\nAverage Turnaround Time: %.2f", st.turnaround.mean);
+
+	printf("\n\nMetric\t\tMean\tMedian\tP95\tP99\tMax");
+	printMetric("Ready wait", &st.waiting);
+	printMetric("Turnaround", &st.turnaround);
+	printMetric("Response", &st.response);
+	if(pproc->ioTime) {
+		printMetric("I/O wait", &st.ioWait);
+	}
+	printf("\nThroughput: %.4f processes per unit time", st.throughput);
+	printf("\nCPU Utilization: %.2f%%", st.utilization * 100 / numCpusArg);
 }
 
+/* One row of statistics table */
+void printMetric(const char *label, const metricSummary *m) {
+	printf("\n%-10s\t%.2f\t%lld\t%lld\t%lld\t%lld", label, m->mean, m->median, m->p95, m->p99, m->max);
+}
 
 /**
- * Function Name: 	priority
- * Function: 		To perform Priority Based Scheduling algorithm
- * Input: 			Process Array, another process array for storing sequence of executed processes
+ * Function Name: 	usage
+ * Function: 		Prints command line help
+ * Input: 			Program name
  * Output:			None
- * Affects:			currentTime, process array structure, sequencing structure i.e. pnames
- * IMP NOTES:		1. IN THIS ALGORITHM, I HAVE TAKEN _PRIORITY BIT_ as arrivalTime bit in structure JUST TO AVOID EXTRA FIELD IN PROCESS STRUCTURE
- * 					2. Here the priority is more if priority bit is high unlike *nix systems where highest priority is for bit 0 and decreases as priority bit value increases.
+ * Affects:			Nothing
  */
 
-void priority(proc process[], names pnames[]) {
-	int i, totalServiceTime;
-	currentTime = 0;
-	puts("Priority Based (Non-Preemptive) Algorithm\n");
-	puts("Enter Number of Processes: ");
-	scanf("%d", &numOfProcesses);
+void usage(const char *progName) {
+	fprintf(stderr, "Usage: %s [--batch fcfs|sjfp|priority|rr|ppriority|mlfq|cfs|policy] [--quantum N] [--aging N]\n", progName);
+	fprintf(stderr, "       [--mlfq-quanta Q0,Q1,...] [--boost N] [--sched-latency N] [--min-granularity N]\n");
+	fprintf(stderr, "       [--realtime-scale SECONDS] [--gantt FROM:[TO][:COLUMNS]] [--policy-lib FILE]\n");
+	fprintf(stderr, "       [--input FILE] [--save-trace FILE] [--sweep MIN:MAX[:STEP] [--sweep-all] [--threads N]]\n");
+	fprintf(stderr, "       [--format text|csv|json|binary] [--verbosity quiet|summary|processes|events] [--output FILE]\n");
+	fprintf(stderr, "       [--stream] [--what-if FILE [--checkpoint-interval N]] [--replay DIR [--threads N]]\n");
+	fprintf(stderr, "       [--cpus N [--balance global|percpu|steal] [--migration-cost T]] [--switch-cost T]\n");
+	fprintf(stderr, "       [--profile] [--profile-trace FILE [--profile-sample N]]\n");
+	fprintf(stderr, "  Without arguments an interactive menu is shown.\n");
+	fprintf(stderr, "  --batch runs one algorithm on the --input trace (stdin by default) and prints\n");
+	fprintf(stderr, "  only the final table and summary. ppriority is Preemptive Priority on arrival time\n");
+	fprintf(stderr, "  and priority of the trace; --aging N raises every waiting process one level at each\n");
+	fprintf(stderr, "  multiple of N ticks, so its first level may come after less than N ticks of waiting.\n");
+	fprintf(stderr, "  mlfq is Multilevel Feedback Queue with a level per quantum of --mlfq-quanta\n");
+	fprintf(stderr, "  (default 2,4,8); --boost N moves every process back to the first level every N ticks.\n");
+	fprintf(stderr, "  cfs is Completely Fair Scheduler weighting processes by priority (nice = -priority);\n");
+	fprintf(stderr, "  every process runs once per --sched-latency ticks (default 24) for at least\n");
+	fprintf(stderr, "  --min-granularity ticks (default 3).\n");
+	fprintf(stderr, "  policy runs the scheduling policy of --policy-lib FILE, a shared object exporting a\n");
+	fprintf(stderr, "  schedPolicy named %s (see policy.h). Its init gets the schedParams of the run,\n", POLICY_SYMBOL);
+	fprintf(stderr, "  so --quantum and the other options reach it. It is reported as with --format and\n");
+	fprintf(stderr, "  runs on one CPU, without --cpus or --stream.\n");
+	fprintf(stderr, "  --format, --verbosity and --output write the report of --batch in text, CSV, JSON or\n");
+	fprintf(stderr, "  binary to FILE (stdout by default): nothing (quiet), summary and percentiles (summary),\n");
+	fprintf(stderr, "  the final table too (processes, the default) or every run of the CPU too (events).\n");
+	fprintf(stderr, "  --input FILE reads processes from a trace instead of asking for them: text lines\n");
+	fprintf(stderr, "  \"name arrival burst [priority]\" (commas or blanks) or a binary trace. \"-\" is stdin.\n");
+	fprintf(stderr, "  burst may be cpu/io/cpu/.../cpu for a process blocking on I/O between CPU bursts; ready\n");
+	fprintf(stderr, "  wait then leaves out I/O wait, which gets a row of its own (one CPU, no --stream or\n");
+	fprintf(stderr, "  --what-if).\n");
+	fprintf(stderr, "  --save-trace FILE converts the --input trace to binary format and exits.\n");
+	fprintf(stderr, "  --stream with --batch fcfs, sjfp or rr schedules the --input trace while reading it,\n");
+	fprintf(stderr, "  keeping only live processes and printing each one as it finishes. Trace must be in\n");
+	fprintf(stderr, "  arrival order; memory stays bounded however long it is.\n");
+	fprintf(stderr, "  --what-if FILE with --batch fcfs, sjfp or rr runs the --input trace taking a checkpoint\n");
+	fprintf(stderr, "  every N ticks (default 1000), then runs FILE, an edited copy of it, from the last\n");
+	fprintf(stderr, "  checkpoint before the first change and prints averages of both.\n");
+	fprintf(stderr, "  --replay DIR runs --batch on every trace file of DIR in parallel (--threads as for\n");
+	fprintf(stderr, "  --sweep), prints averages of each and percentiles over every process of all of them.\n");
+	fprintf(stderr, "  --gantt FROM:TO:COLUMNS draws the Gantt chart (also in --batch) only from tick FROM to TO\n");
+	fprintf(stderr, "  (default end of run) in COLUMNS columns (default 16); \"**\" marks a column shared by\n");
+	fprintf(stderr, "  several processes none of which ran for half of it.\n");
+	fprintf(stderr, "  --realtime-scale keeps the animated per tick output, sleeping SECONDS per tick.\n");
+	fprintf(stderr, "  --sweep runs Round Robin on the --input trace for every quantum from MIN to MAX\n");
+	fprintf(stderr, "  in parallel and prints averages and context switches of each; --sweep-all adds\n");
+	fprintf(stderr, "  the other algorithms, --threads sets number of threads (default one per CPU).\n");
+	fprintf(stderr, "  --cpus runs fcfs, sjfp, priority or rr on N CPUs with one global ready queue, or with\n");
+	fprintf(stderr, "  a queue per CPU (--balance percpu) balanced by work stealing (--balance steal). A process\n");
+	fprintf(stderr, "  resuming on another CPU costs that CPU T ticks (--migration-cost). Gantt chart gets a lane\n");
+	fprintf(stderr, "  per CPU.\n");
+	fprintf(stderr, "  --switch-cost T makes every context switch take T ticks of CPU time (\"><\" in Gantt chart)\n");
+	fprintf(stderr, "  and adds preemptions, switch and idle time and ready queue length to the summary.\n");
+	fprintf(stderr, "  --cpus and --switch-cost do not work with --stream.\n");
+	fprintf(stderr, "  --profile prints to stderr at exit how long the program spent loading, sorting,\n");
+	fprintf(stderr, "  simulating, computing statistics and writing output, and how many scheduling decisions,\n");
+	fprintf(stderr, "  ready queue operations, wakeups and arena allocations it made. --profile-trace FILE\n");
+	fprintf(stderr, "  writes the phases and one dispatch in N (--profile-sample, default 100, 0 for none) as\n");
+	fprintf(stderr, "  Chrome trace JSON for chrome://tracing or Perfetto. Builds with NDEBUG (make release)\n");
+	fprintf(stderr, "  leave profiling out.\n");
+}
 
-	for(i=0; i<numOfProcesses; i++) {
-		printf("Enter Process Name(Max 2 chars): ");
-		scanf("%s", process[i].name);
-		printf("Enter Priority for Process %s: ", process[i].name);
-		scanf("%d", &process[i].arrivalTime);
-		printf("Enter Burst Time for Process %s: ", process[i].name);
-		scanf("%d", &process[i].burstTime);
+/**
+ * Function Name: 	parseQuanta
+ * Function: 		Parses comma separated quanta of --mlfq-quanta, one level per quantum
+ * Input: 			"Q0,Q1,...", MLFQ parameters to fill
+ * Output:			0 on success, -1 if a quantum is not positive or there are too many levels
+ * Affects:			MLFQ parameters (only on success)
+ */
 
-		/* Initialise other properties accordingly*/
-		process[i].startTime = 0;
-		process[i].waitingTime = 0;
-		process[i].IsActiveFor = 0;
+int parseQuanta(const char *arg, mlfqParams *mp) {
+	mlfqParams parsed = *mp;
+	char *end;
 
+	parsed.levels = 0;
+	do {
+		if(parsed.levels == MLFQ_MAX_LEVELS) {
+			return -1;
+		}
+		parsed.quantum[parsed.levels] = strtoll(arg, &end, 10);
+		if(end == arg || parsed.quantum[parsed.levels++] <= 0) {
+			return -1;
+		}
+		arg = end + 1;
+	} while(*end == ',');
+	if(*end != '\0') {
+		return -1;
 	}
+	*mp = parsed;
+	return 0;
+}
 
-	printf("\n\nPName\tPriority\tBTime\n");
+/**
+ * Function Name: 	loadPolicy
+ * Function: 		Loads the shared object of --policy-lib and takes the schedPolicy it exports as POLICY_SYMBOL
+ * Input: 			Path of the shared object
+ * Output:			0 on success, -1 if it cannot be loaded or exports no policy (message already printed)
+ * Affects:			policyArg. The object stays loaded till the program exits
+ */
 
-	for(i=0; i<numOfProcesses; i++) {
-		printf("\n%s\t%d\t\t%d", process[i].name, process[i].arrivalTime, process[i].burstTime);
-	}
+int loadPolicy(const char *path) {
+	void *lib = dlopen(path, RTLD_NOW);
 
-	prioSort(process, numOfProcesses);
+	if(lib == NULL || (policyArg = dlsym(lib, POLICY_SYMBOL)) == NULL) {
+		fprintf(stderr, "%s\n", dlerror());
+		return -1;
+	}
+	return 0;
+}
 
-	puts("\n");
+/**
+ * Function Name: 	parseBalance
+ * Function: 		Parses balancing of --balance
+ * Input: 			"global", "percpu" or "steal"
+ * Output:			BALANCE_GLOBAL, BALANCE_PERCPU or BALANCE_STEAL, -1 if unknown
+ * Affects:			Nothing
+ */
 
-	totalServiceTime = getTotalBurstTime(process, numOfProcesses);
-	printf("\nTotal Burst Time: %d \n", totalServiceTime );
+int parseBalance(const char *arg) {
+	static const char *name[] = { "global", "percpu", "steal" };
+	int i;
 
-	for (i=0; i<numOfProcesses; i++) {
-		for(; process[i].burstTime > 0; process[i].burstTime -= 1) {
-			printf("\nFetching next Process...\n");
-			printf("\nExecuting process %s ...\n", process[i].name);
-			system("sleep 1");
-			strcpy(pnames[currentTime].name, process[i].name);
-			process[i].IsActiveFor += 1;
-			currentTime +=1;
+	for(i=BALANCE_GLOBAL; i<=BALANCE_STEAL; i++) {
+		if(strcmp(arg, name[i]) == 0) {
+			return i;
 		}
-		process[i].finishTime = currentTime;
-		process[i+1].startTime = currentTime;
-		/*If we consider arrival time then use this
-		process[i].waitingTime = process[i].startTime - process[i].arrivalTime;
-		*/
-		process[i+1].waitingTime = process[i+1].startTime;
-
 	}
+	return -1;
+}
 
+/**
+ * Function Name: 	parseSweep
+ * Function: 		Parses quantum range of --sweep
+ * Input: 			"MIN:MAX" or "MIN:MAX:STEP", sweep to fill
+ * Output:			0 on success, -1 if range is invalid
+ * Affects:			Sweep
+ */
 
+int parseSweep(const char *arg, sweepSpec *spec) {
+	int fields;
 
-	printf("\n\nPName\tPriority\tBTime\tSTime\tFTime\tWTime\tTATime\n");
-
-
-	/*Display final table*/
-	for(i=0; i<numOfProcesses; i++) {
-		printf("\n%s\t%d\t\t%d\t%d\t%d\t%d\t%d", process[i].name, process[i].arrivalTime, process[i].IsActiveFor,
-				process[i].startTime, process[i].finishTime, process[i].waitingTime, process[i].finishTime - 0);
+	spec->step = 1;
+	fields = sscanf(arg, "%lld:%lld:%lld", &spec->minQuantum, &spec->maxQuantum, &spec->step);
+	if(fields < 2 || spec->minQuantum <= 0 || spec->maxQuantum < spec->minQuantum || spec->step <= 0) {
+		return -1;
 	}
+	return 0;
+}
 
+/**
+ * Function Name: 	parseGantt
+ * Function: 		Parses window of --gantt. Without TO the window ends with the run, COLUMNS defaults to 16
+ * Input: 			"FROM:[TO][:COLUMNS]"
+ * Output:			0 on success, -1 if window is invalid
+ * Affects:			Gantt chart window
+ */
 
-	printf("\n\nAll Processes executed...\n\n");
-
-	printf("Gantt Chart:\n");
+int parseGantt(const char *arg) {
+	simTime from, to = -1;
+	long long columns = 16;
+	char *end;
 
-	/**
-	 * Displaying time axis
-	 * NOTE: This is not generic for loop. YOU HAVE TO ADJUST value of i, and font size of terminal accordingly to get proper view in line
-	 */
-	for(i=0; i<=currentTime; i++) {
-		printf("|%2d ",i);
+	from = strtoll(arg, &end, 10);
+	if(end == arg || *end != ':' || from < 0) {
+		return -1;
 	}
-	printf("\n");
-
-	/*Display processes sequentially*/
-	for(i=0; i<currentTime; i++) {
-		printf("|%s  ", pnames[i].name );
+	arg = end + 1;
+	if(*arg != ':' && *arg != '\0') {
+		to = strtoll(arg, &end, 10);
+		if(end == arg || to <= from) {
+			return -1;
+		}
+		arg = end;
 	}
-	printf("|\n");
-
-
-
+	if(*arg == ':') {
+		columns = strtoll(arg + 1, &end, 10);
+		if(end == arg + 1 || columns < 1 || columns > 100000) {
+			return -1;
+		}
+		arg = end;
+	}
+	if(*arg != '\0') {
+		return -1;
+	}
+	ganttFrom = from;
+	ganttTo = to;
+	ganttColumns = (int)columns;
+	return 0;
 }
 
-
 /**
- * Function Name: 	priSort
- * Function: 		To perform sorting of processes based on priorities algorithm. The processes are sorted in descending order of their priorities.
- * Input: 			Process Array, Total number of process
- * Output:			Sorted Process Array according to highest priority first
- * Affects:			Process Array
- * IMP NOTES:		Considering the arrivalTime as priority bit.
+ * Function Name: 	sweepMode
+ * Function: 		Loads the trace once, runs the sweep on it and prints one row per run
+ * Input: 			Sweep
+ * Output:			0 on success, -1 on error (message already printed)
+ * Affects:			Nothing
  */
 
-void prioSort(proc pproc[], int numOfProcesses) {
-	int i, j, test;
-	proc temp;
-
-	for(i = numOfProcesses - 1; i > 0; i--) {
-		test = 0;
-		for(j=0; j < i; j++) {
-			if((pproc[j].arrivalTime) < (pproc[j+1].arrivalTime) ) {
-				temp = pproc[j];
-				pproc[j] = pproc[j+1];
-				pproc[j+1] = temp;
-				test=1;
+int sweepMode(const sweepSpec *spec) {
+	static const char *name[] = { "", "fcfs", "sjfp", "priority", "rr" };
+	arena runArena;
+	workload wl;
+	sweepResult *r;
+	int count, i, swept, ret = -1;
+
+	if(loadWorkload(inputPath ? inputPath : "-", &runArena, 0, &wl) == 0) {
+		/*Runs are timed on the threads doing them, waiting for them is no phase*/
+		PROF_END(PROF_OUTPUT);
+		swept = runSweep(&wl, spec, &r, &count);
+		PROF_BEGIN(PROF_OUTPUT);
+		if(swept != 0) {
+			fprintf(stderr, "Not enough memory or threads for sweep\n");
+		} else {
+			ret = 0;
+			printf("Algo\tQuantum\tAvgWTime\tAvgTATime\tSwitches\tTotalTime\tPreempts\tSwitchTime\n");
+			for(i=0; i<count; i++) {
+				if(r[i].failed) {
+					printf("%s\t%lld\tout of memory\n", name[r[i].algo], r[i].quantum);
+					ret = -1;
+					continue;
+				}
+				printf("%s\t", name[r[i].algo]);
+				if(r[i].algo == ALGO_RR) {
+					printf("%lld", r[i].quantum);
+				} else {
+					printf("-");
+				}
+				printf("\t%.2f\t\t%.2f\t\t%lld\t\t%lld\t\t%lld\t\t%lld\n", r[i].avgWaiting, r[i].avgTurnaround,
+						r[i].contextSwitches, r[i].totalTime, r[i].preemptions, r[i].switchTime);
 			}
+			free(r);
 		}
-		if(test==0) break;
 	}
+	freeWorkload(&wl);
+	arenaFree(&runArena);
+	return ret;
 }
 
 /**
- * Function Name: 	roundrobin
- * Function: 		To perform Round Robin Scheduling algorithm
- * Input: 			Process Array, another process array for storing sequence of executed processes
- * Output:			None
- * Affects:			currentTime, process array structure, sequencing structure i.e. pnames
+ * Function Name: 	streamMode
+ * Function: 		Schedules the trace online, printing every process as it finishes followed by the averages.
+ * 					Output is not sorted, percentiles are left out since they need every process
+ * Input: 			Algorithm (ALGO_FCFS, ALGO_SJFP or ALGO_RR)
+ * Output:			0 on success, -1 on error (message already printed)
+ * Affects:			Nothing
  */
 
-void roundrobin(proc process[], names pnames[]) {
-	int i, j, totalServiceTime, timeQuanta;
-
-	currentTime = 0;
-	puts("Round Robin Algorithm\n");
-	puts("Enter Number of Processes: ");
-	scanf("%d", &numOfProcesses);
-
-	for(i=0; i<numOfProcesses; i++) {
-		printf("Enter Process Name(Max 2 chars): ");
-		scanf("%s", process[i].name);
-		printf("Enter Arrival Time for Process %s: ", process[i].name);
-		scanf("%d", &process[i].arrivalTime);
-		printf("Enter Burst Time for Process %s: ", process[i].name);
-		scanf("%d", &process[i].burstTime);
-
-		/* Initialise other properties accordingly*/
-		process[i].startTime = -1;
-		process[i].waitingTime = 0;
-		process[i].IsActiveFor = 0;
+int streamMode(int algo) {
+	traceReader reader;
+	streamResult res;
+	int ret, headerShown = 0;
 
+	if(switchCostArg > 0 || numCpusArg > 1) {
+		fprintf(stderr, "Streaming runs on one CPU without switch cost, --cpus and --switch-cost cannot be used\n");
+		return -1;
 	}
-
-	printf("Enter Time Quanta: ");
-	scanf("%d", &timeQuanta);
-
-	printf("\n\nPName\tArrTime\tBTime\n");
-
-	for(i=0; i<numOfProcesses; i++) {
-		printf("\n%s\t%d\t%d", process[i].name, process[i].arrivalTime, process[i].burstTime);
+	if(traceOpen(inputPath, &reader) != 0) {
+		return -1;
 	}
+	PROF_BEGIN(PROF_SIMULATE);		/*Reading the trace is part of it*/
+	ret = simulateStream(&reader, algo, timeQuantaArg, printDone, &headerShown, &res);
+	PROF_END(PROF_SIMULATE);
+	traceClose(&reader);
+
+	if(res.processes > 0) {
+		printf("\nTotal Time: %lld", res.totalTime);
+		printf("\nAverage Waiting Time: %.2f", (double)res.sumWaiting / res.processes);
+		printf("\nAverage Turnaround Time: %.2f", (double)res.sumTurnaround / res.processes);
+		printf("\nProcesses: %lld, Most alive at once: %d", res.processes, res.peakLive);
+		if(res.totalTime > 0) {
+			printf("\nThroughput: %.4f processes per unit time", (double)res.processes / res.totalTime);
+			printf("\nCPU Utilization: %.2f%%", 100.0 * res.busyTime / res.totalTime);
+		}
+		printf("\n");
+	}
+	return ret;
+}
 
-	psort(process, numOfProcesses);
-	puts("\n");
+/* Row of a finished process, same columns as the final table of the algorithms. Header comes with the first one */
+void printDone(const streamJob *job, void *arg) {
+	int *headerShown = arg;
 
-	totalServiceTime = getTotalBurstTime(process, numOfProcesses);
-	printf("\nTotal Burst Time: %d \n", totalServiceTime );
+	if(!*headerShown) {
+		printf("PName\tArrTime\tBTime\tSTime\tFTime\tWTime\tTATime\n");
+		*headerShown = 1;
+	}
+	printf("%s\t%lld\t%lld\t%lld\t%lld\t%lld\t%lld\n", job->name, job->arrivalTime, job->burstTime, job->startTime,
+			job->finishTime, job->startTime - job->arrivalTime, job->finishTime - job->arrivalTime);
+}
 
-	for (i = 0; currentTime <= totalServiceTime-1; i++) {
+/**
+ * Function Name: 	whatIfMode
+ * Function: 		Runs the --input trace taking checkpoints, then the changed trace resuming from them, and prints
+ * 					averages of both runs
+ * Input: 			Algorithm (ALGO_FCFS, ALGO_SJFP or ALGO_RR), path of changed trace
+ * Output:			0 on success, -1 on error (message already printed)
+ * Affects:			Nothing
+ */
 
-		/*To keep looping in a round fashion for given number of processes e.g.  1 2 3 1 2 3 1 2 3... */
-		if (i == numOfProcesses) {
-			i=0;
+int whatIfMode(int algo, const char *changedPath) {
+	arena baseArena, changedArena;
+	workload base, changed;
+	checkpointLog log;
+	schedParams params = { 0 };
+	schedResult before, after;
+	int ret = -1;
+
+	memset(&changed, 0, sizeof(changed));
+	memset(&before, 0, sizeof(before));
+	memset(&after, 0, sizeof(after));
+	changedArena.current = NULL;
+	params.quantum = timeQuantaArg;
+	params.switchCost = switchCostArg;
+	params.checkpoints = &log;
+	checkpointInit(&log, checkpointArg);
+	if(loadWorkload(inputPath, &baseArena, 0, &base) == 0 && loadWorkload(changedPath, &changedArena, 0, &changed) == 0) {
+		if(base.table.ioLeft || changed.table.ioLeft) {
+			fprintf(stderr, "Traces with I/O bursts cannot take checkpoints\n");
+		} else if(sched_run(algo, &base, &params, &before) != 0 || sched_rerun(algo, &changed, &params, &before, &after) != 0) {
+			fprintf(stderr, "Not enough memory for run or algorithm cannot take checkpoints (fcfs, sjfp, rr only)\n");
+		} else {
+			ret = 0;
+			printf("Trace\tAvgWTime\tAvgTATime\tSwitches\tTotalTime\n");
+			printf("base\t%.2f\t\t%.2f\t\t%lld\t\t%lld\n", before.avgWaiting, before.avgTurnaround,
+					before.contextSwitches, before.totalTime);
+			printf("what-if\t%.2f\t\t%.2f\t\t%lld\t\t%lld\n", after.avgWaiting, after.avgTurnaround,
+					after.contextSwitches, after.totalTime);
 		}
+		sched_result_free(&after);
+		sched_result_free(&before);
+	}
+	checkpointFree(&log);
+	freeWorkload(&changed);
+	arenaFree(&changedArena);
+	freeWorkload(&base);
+	arenaFree(&baseArena);
+	return ret;
+}
 
-		/*Execute current selected process for given Time Quantum*/
-		for (j = 0; j < timeQuanta; j++) {
-
-			/*Execute only if process has arrived*/
-			if(process[i].arrivalTime <= currentTime) {
-				if(process[i].burstTime == 0) {
-					continue;						/*If burstTime is zero then we have executed the process already so skip pass*/
-				}
-
-				process[i].burstTime -=1;			/*Decrease burst time and increase active time*/
-				process[i].IsActiveFor += 1;
-
+/**
+ * Function Name: 	replayMode
+ * Function: 		Runs the algorithm on every trace of a directory, then prints one row per trace and statistics
+ * 					over the processes of all traces
+ * Input: 			Algorithm, directory, number of threads (0 = one per CPU)
+ * Output:			0 on success, -1 on error or if a trace failed (message already printed)
+ * Affects:			Nothing
+ */
 
-				if(process[i].startTime == -1) {		/*If process is being executed for first time then current time is start time*/
-					process[i].startTime = currentTime;
-				}
+int replayMode(int algo, const char *dir, int numThreads) {
+	replaySpec spec;
+	replayResult fleet;
+	replayTrace *r;
+	int i, ret;
+
+	memset(&spec, 0, sizeof(spec));
+	spec.algo = algo;
+	spec.numThreads = numThreads;
+	spec.params.quantum = timeQuantaArg;
+	spec.params.agingInterval = agingArg;
+	spec.params.mlfq = mlfqArg;
+	spec.params.cfs = cfsArg;
+	spec.params.policy = policyArg;
+	spec.params.policyParams = &spec.params;
+	setCpus(&spec.params);
+	spec.params.onCpuRun = NULL;
+
+	/*Traces are loaded and run on the threads of the replay, waiting for them is no phase*/
+	PROF_END(PROF_OUTPUT);
+	ret = runReplay(dir, &spec, &fleet);
+	PROF_BEGIN(PROF_OUTPUT);
+	if(ret != 0) {
+		fprintf(stderr, "Cannot read %s or not enough memory or threads for replay\n", dir);
+		replayFree(&fleet);
+		return -1;
+	}
+	printf("Trace\tProcesses\tAvgWTime\tAvgTATime\tSwitches\tTotalTime\n");
+	for(i=0; i<fleet.numTraces; i++) {
+		r = &fleet.trace[i];
+		if(r->failed) {
+			printf("%s\tfailed\n", r->name);
+		} else {
+			printf("%s\t%d\t\t%.2f\t\t%.2f\t\t%lld\t\t%lld\n", r->name, r->processes, r->avgWaiting, r->avgTurnaround,
+					r->contextSwitches, r->totalTime);
+		}
+	}
+	printf("\nTraces: %d, Failed: %d, Processes: %d", fleet.numTraces, fleet.failed, fleet.processes);
+	if(fleet.processes > 0) {
+		printf("\n\nMetric\t\tMean\tMedian\tP95\tP99\tMax");
+		printMetric("Ready wait", &fleet.waiting);
+		printMetric("Turnaround", &fleet.turnaround);
+		printMetric("Response", &fleet.response);
+	}
+	printf("\n");
+	ret = fleet.failed ? -1 : 0;
+	replayFree(&fleet);
+	return ret;
+}
 
-				printf("\nFetching next Process...\n");
-				printf("\nExecuting process %s ...\n", process[i].name);
-				system("sleep 1");
-				strcpy(pnames[currentTime].name, process[i].name);		/*Store it for further display*/
-				currentTime +=1;										/*Increase current Time*/
-				if(process[i].burstTime == 0) {							/*If burst time becomes zero mark the finish time of process*/
-					process[i].finishTime = currentTime;
-				}
+/**
+ * Function Name: 	reportMode
+ * Function: 		Runs one algorithm on the --input trace writing the report asked for by --format, --verbosity
+ * 					and --output. Runs are only written at VERBOSITY_EVENTS and nothing is formatted or written
+ * 					at VERBOSITY_QUIET, so a quiet run costs loading and scheduling only
+ * Input: 			Algorithm (ALGO_FCFS .. ALGO_LAST)
+ * Output:			0 on success, -1 on error (message already printed)
+ * Affects:			File of --output
+ */
 
+int reportMode(int algo) {
+	arena runArena;
+	workload wl;
+	outStream out;
+	schedParams params = { 0 };
+	schedResult run;
+	runStats st;
+	int ret = -1, events = verbosityArg == VERBOSITY_EVENTS;
+
+	memset(&run, 0, sizeof(run));
+	params.quantum = timeQuantaArg;
+	params.agingInterval = agingArg;
+	params.mlfq = mlfqArg;
+	params.cfs = cfsArg;
+	params.policy = policyArg;
+	params.policyParams = &params;
+	setCpus(&params);
+	params.onRun = events ? reportSegment : NULL;
+	params.onCpuRun = events ? reportCpuSegment : NULL;
+	params.arg = &out;
+
+	if(loadWorkload(inputPath, &runArena, 0, &wl) == 0 &&
+			(verbosityArg == VERBOSITY_QUIET || outOpen(&out, outputPath ? outputPath : "-", formatArg, verbosityArg) == 0)) {
+		if(sched_run(algo, &wl, &params, &run) != 0) {
+			fprintf(stderr, "Not enough memory to run processes or algorithm cannot run on several CPUs\n");
+		} else {
+			ret = 0;
+		}
+		if(ret == 0 && verbosityArg >= VERBOSITY_PROCESSES) {
+			outProcesses(&out, &run.table, run.arrivalIsPriority);
+		}
+		if(ret == 0 && verbosityArg >= VERBOSITY_SUMMARY && run.table.numOfProcesses > 0) {
+			if(computeStats(&run.table, run.totalTime, run.arrivalIsPriority, &st) != 0) {
+				fprintf(stderr, "Not enough memory for statistics\n");
+				ret = -1;
 			} else {
-				currentTime +=1;										/*This part is not tested but only primary implementation is done for process those are not yet arrived and there's no process to be executed. Filling the IDLE TIME GAP*/
-				printf("\nNo Process is being executed..\n");
-				/*
-				 * TODO:
-				 * Code for copying a space should come here.
-				 */
-
+				outSummary(&out, &run, &st, numCpusArg);
+				outCounters(&out, &run, switchCostArg);
 			}
 		}
-
+		if(verbosityArg != VERBOSITY_QUIET && outClose(&out) != 0) {
+			ret = -1;
+		}
+		sched_result_free(&run);
 	}
+	freeWorkload(&wl);
+	arenaFree(&runArena);
+	return ret;
+}
 
+/* Run of the CPU written as a segment of the report */
+void reportSegment(const procTable *pproc, int running, simTime start, simTime length, void *arg) {
+	outSegment(arg, 0, running, pproc, start, length);
+}
 
+void reportCpuSegment(const procTable *pproc, int cpu, int running, simTime start, simTime length, void *arg) {
+	outSegment(arg, cpu, running, pproc, start, length);
+}
 
+/**
+ * Function Name: 	startProfiling
+ * Function: 		Turns on profiling of --profile and --profile-trace. Everything the program does from here on
+ * 					which is no other phase counts as output; the phase is left when the profile is written at exit
+ * Input: 			None
+ * Output:			0 on success (or when profiling is not built in), -1 if out of memory
+ * Affects:			Profiler
+ */
 
-
-	printf("\n\nPName\tArrTime\tBTime\tSTime\tFTime\tWTime\tTATime\n");
-
-
-	/*Display final table*/
-	for(i=0; i<numOfProcesses; i++) {
-		printf("\n%s\t%d\t%d\t%d\t%d\t%d\t%d", process[i].name, process[i].arrivalTime, process[i].IsActiveFor,
-				process[i].startTime, process[i].finishTime, process[i].startTime - process[i].arrivalTime, process[i].finishTime - process[i].arrivalTime);
+int startProfiling(void) {
+#ifdef PROFILING
+	if(profStart(profileTracePath ? PROFILE_EVENTS : 0, profileSampleArg) != 0) {
+		return -1;
 	}
+	PROF_BEGIN(PROF_OUTPUT);
+	atexit(stopProfiling);
+#else
+	fprintf(stderr, "Profiling is not built in (compiled with NDEBUG), --profile and --profile-trace are ignored\n");
+#endif
+	return 0;
+}
 
-
-	printf("\n\nAll Processes executed...\n\n");
-
-	printf("Gantt Chart:\n");
-
-	/**
-	 * Displaying time axis
-	 * NOTE: This is not generic for loop. YOU HAVE TO ADJUST value of i, and font size of terminal accordingly to get proper view in line
-	 */
-	for(i=0; i<=currentTime; i++) {
-		printf("|%2d ",i);
+void stopProfiling(void) {
+#ifdef PROFILING
+	fflush(stdout);
+	PROF_END(PROF_OUTPUT);
+	profStop();
+	if(profileArg) {
+		profReport(stderr);
 	}
-	printf("\n");
-
-	/*Display processes sequentially*/
-	for(i=0; i<currentTime; i++) {
-		printf("|%s  ", pnames[i].name );
+	if(profileTracePath) {
+		profWriteTrace(profileTracePath);
 	}
-	printf("|\n");
-
-
+#endif
 }
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
 /* These line is purposefully written at end */
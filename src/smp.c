@@ -0,0 +1,406 @@
+/*
+ ============================================================================
+ Name        : smp.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Multi CPU discrete event core, see smp.h. At every event
+               (arrival or end of a slice on some CPU) finished and
+               preempted processes are retired, arrivals are queued, idle
+               CPUs pick work and, for Shortest Job First, a queued process
+               shorter than a running one preempts it. With one CPU the
+               schedule is the same as the one of simulate().
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "smp.h"
+#include "profile.h"
+
+typedef struct {
+	simTime key;				/* Remaining burst (Shortest Job First) or round of the walk (Round Robin) */
+	int index;
+}queueEntry;
+
+/*
+ * Ready queue of one CPU (or of all of them). Ring buffer for FIFO algorithms,
+ * binary min-heap on (key, index) for Shortest Job First and Round Robin.
+ * Round Robin walks its queue in arrival order as simulate() does: a process
+ * after the one picked last runs in its round, one up to it in the next.
+ * Per CPU queues start small and double when full, so N queues do not need N
+ * times the table.
+ */
+typedef struct {
+	queueEntry *entry;
+	int head;
+	int count;
+	int size;
+	int isHeap;
+	int isWalk;					/* Round Robin, key is the round */
+	simTime round;				/* Round of the process picked last */
+	int last;					/* Process picked last, -1 before the first pick */
+}runQueue;
+
+typedef struct {
+	int running;				/* Process on the CPU, IDLE_PROCESS if none */
+	int preempted;				/* Process taken off at this event, waiting to be queued again */
+	simTime dispatched;			/* When running was put on the CPU */
+	simTime switched;			/* dispatched plus switch cost */
+	simTime runFrom;			/* switched plus migration cost */
+	simTime sliceEnd;
+	simTime idleSince;
+	int lastRun;				/* Last process that made progress on the CPU, for counting switches */
+	int lastUnfinished;			/* It had not finished when it left */
+}cpuState;
+
+static int before(const queueEntry *a, const queueEntry *b) {
+	return a->key < b->key || (a->key == b->key && a->index < b->index);
+}
+
+static int qInit(runQueue *q, int size, int algo) {
+	q->size = size > 0 ? size : 1;
+	q->head = 0;
+	q->count = 0;
+	q->isWalk = algo == ALGO_RR;
+	q->isHeap = algo == ALGO_SJFP || q->isWalk;
+	q->round = 0;
+	q->last = -1;
+	q->entry = malloc(q->size * sizeof(queueEntry));
+	return q->entry ? 0 : -1;
+}
+
+/* Doubles the queue, unwrapping the ring */
+static int qGrow(runQueue *q) {
+	queueEntry *grown = malloc(2 * q->size * sizeof(queueEntry));
+	int i;
+
+	if(grown == NULL) {
+		return -1;
+	}
+	for(i=0; i<q->count; i++) {
+		grown[i] = q->entry[(q->head + i) % q->size];
+	}
+	free(q->entry);
+	q->entry = grown;
+	q->head = 0;
+	q->size *= 2;
+	return 0;
+}
+
+static int qPush(runQueue *q, int index, simTime key) {
+	queueEntry e = { key, index };
+	int i, parent;
+
+	if(q->count == q->size && qGrow(q) != 0) {
+		return -1;
+	}
+	if(q->isWalk) {
+		e.key = index > q->last ? q->round : q->round + 1;
+	}
+	if(!q->isHeap) {
+		q->entry[(q->head + q->count++) % q->size] = e;
+		return 0;
+	}
+	for(i=q->count++; i>0; i=parent) {
+		parent = (i - 1) / 2;
+		if(!before(&e, &q->entry[parent])) {
+			break;
+		}
+		q->entry[i] = q->entry[parent];
+	}
+	q->entry[i] = e;
+	return 0;
+}
+
+/* Head of FIFO or smallest entry of heap */
+static const queueEntry *qTop(const runQueue *q) {
+	return &q->entry[q->isHeap ? 0 : q->head];
+}
+
+static int qPop(runQueue *q) {
+	int index = qTop(q)->index, i = 0, child;
+	queueEntry last;
+
+	if(q->isWalk) {
+		q->round = qTop(q)->key;
+		q->last = index;
+	}
+	if(!q->isHeap) {
+		q->head = (q->head + 1) % q->size;
+		q->count--;
+		return index;
+	}
+	last = q->entry[--q->count];
+	while((child = 2 * i + 1) < q->count) {
+		if(child + 1 < q->count && before(&q->entry[child + 1], &q->entry[child])) {
+			child++;
+		}
+		if(!before(&q->entry[child], &last)) {
+			break;
+		}
+		q->entry[i] = q->entry[child];
+		i = child;
+	}
+	q->entry[i] = last;
+	return index;
+}
+
+/* Takes from the cold end: tail of FIFO, last leaf of heap. Neither needs reordering */
+static int qSteal(runQueue *q) {
+	q->count--;
+	return q->entry[q->isHeap ? q->count : (q->head + q->count) % q->size].index;
+}
+
+/* Queue used by a CPU */
+static runQueue *queueOf(runQueue *queues, const smpParams *p, int cpu) {
+	return p->balance == BALANCE_GLOBAL ? &queues[0] : &queues[cpu];
+}
+
+/* CPU with fewest queued and running processes, ties to lowest number */
+static int leastLoaded(const runQueue *queues, const cpuState *cpu, int numCpus) {
+	int c, best = 0, load, bestLoad = -1;
+
+	for(c=0; c<numCpus; c++) {
+		load = queues[c].count + (cpu[c].running != IDLE_PROCESS);
+		if(bestLoad < 0 || load < bestLoad) {
+			best = c;
+			bestLoad = load;
+		}
+	}
+	return best;
+}
+
+/* Process running on a CPU keyed on its remaining burst at time now */
+static queueEntry onCpu(const procTable *t, const cpuState *cs, simTime now) {
+	queueEntry e;
+
+	e.index = cs->running;
+	e.key = t->burstTime[e.index] - (now > cs->runFrom ? now - cs->runFrom : 0);
+	return e;
+}
+
+/*
+ * Takes the process off a CPU at time now, reporting switch and migration cost and run.
+ * Returns 1 if it finished.
+ */
+static int stopRun(procTable *t, int algo, int c, cpuState *cs, simTime now, engineCounters *ec, cpuRunCallback onRun, void *arg) {
+	int p = cs->running;
+	simTime ran = now > cs->runFrom ? now - cs->runFrom : 0;
+	simTime paid = (now < cs->runFrom ? now : cs->runFrom) - cs->dispatched;
+	simTime switching = (now < cs->switched ? now : cs->switched) - cs->dispatched;
+
+	if(onRun && switching > 0) onRun(t, c, SWITCHING_PROCESS, cs->dispatched, switching, arg);
+	if(onRun && paid > switching) onRun(t, c, MIGRATING_PROCESS, cs->dispatched + switching, paid - switching, arg);
+	if(onRun && ran > 0) onRun(t, c, p, cs->runFrom, ran, arg);
+	ec->switchTime += switching;
+	t->burstTime[p] -= ran;
+	t->IsActiveFor[p] += ran;
+	if(ran > 0) {
+		if(cs->lastRun != IDLE_PROCESS && cs->lastRun != p) {
+			ec->switches++;
+			ec->preemptions += cs->lastUnfinished;
+		}
+		cs->lastRun = p;
+		cs->lastUnfinished = t->burstTime[p] > 0;
+	}
+	cs->running = IDLE_PROCESS;
+	cs->idleSince = now;
+	if(t->burstTime[p] == 0) {
+		t->finishTime[p] = now;
+		t->waitingTime[p] = t->startTime[p] - (algo == ALGO_PRIORITY ? 0 : t->arrivalTime[p]);
+		return 1;
+	}
+	cs->preempted = p;
+	return 0;
+}
+
+/* Puts process on an idle CPU at time now */
+static void startRun(procTable *t, int algo, const smpParams *sp, int c, cpuState *cs, int p, int *lastCpu,
+		simTime now, smpCounters *counters, cpuRunCallback onRun, void *arg) {
+	simTime slice = t->burstTime[p];
+
+	if(onRun && now > cs->idleSince) onRun(t, c, IDLE_PROCESS, cs->idleSince, now - cs->idleSince, arg);
+	counters->engine.idleTime += now - cs->idleSince;
+	cs->running = p;
+	cs->dispatched = now;
+	cs->switched = now;
+	if(cs->lastRun != IDLE_PROCESS && cs->lastRun != p) {
+		cs->switched += sp->switchCost;
+	}
+	cs->runFrom = cs->switched;
+	if(lastCpu[p] >= 0 && lastCpu[p] != c) {
+		cs->runFrom += sp->migrationCost;
+		counters->migrations++;
+	}
+	lastCpu[p] = c;
+	if(t->startTime[p] == -1) {
+		t->startTime[p] = cs->runFrom;
+	}
+	if(algo == ALGO_RR && slice > sp->quantum) {
+		slice = sp->quantum;
+	}
+	cs->sliceEnd = cs->runFrom + slice;
+	PROF_TALLY(counters->engine.queueOps++);
+	PROF_TALLY(counters->engine.decisions++);
+	PROF_DISPATCH(counters->engine.decisions, p, cs->runFrom, slice);
+}
+
+/**
+ * Function Name: 	simulateSmp
+ * Function:		Runs given scheduling algorithm over the process table on several CPUs using discrete events
+ * Input:			Process table sorted as for simulate(), algorithm, CPUs and balancing, callback for every run
+ * 					of every CPU and its argument, counters to fill
+ * Output:			Time at which last process finished, -1 if out of memory or number of CPUs is not positive
+ * Affects:			burstTime (becomes zero), startTime, finishTime, waitingTime, IsActiveFor of every process
+ * NOTES:			For ALGO_PRIORITY arrivalTime holds priority, so every process is taken as arrived at 0.
+ * 					startTime is when the process first made progress. A switch is counted once the process
+ * 					switched to makes progress, switch cost is paid as soon as it is dispatched.
+ */
+
+simTime simulateSmp(procTable *t, int algo, const smpParams *sp, cpuRunCallback onRun, void *arg, smpCounters *counters) {
+	int numOfProcesses = t->numOfProcesses, numCpus = sp->numCpus;
+	int numQueues = sp->balance == BALANCE_GLOBAL ? 1 : numCpus;
+	int isSjf = algo == ALGO_SJFP;
+	int nextArrival = 0, done = 0, ok, i, c, victim, worst, p, ready;
+	simTime now = 0, next;
+	runQueue *queues, *q;
+	queueEntry running, longest = { 0, IDLE_PROCESS };
+	cpuState *cpu;
+	int *lastCpu;
+
+	memset(counters, 0, sizeof(*counters));
+	if(numCpus < 1) {
+		return -1;
+	}
+	queues = calloc(numQueues, sizeof(runQueue));
+	cpu = calloc(numCpus, sizeof(cpuState));
+	lastCpu = malloc((numOfProcesses > 0 ? numOfProcesses : 1) * sizeof(int));
+	ok = queues != NULL && cpu != NULL && lastCpu != NULL;
+	for(c=0; ok && c<numQueues; c++) {
+		ok = qInit(&queues[c], numQueues == 1 ? numOfProcesses : numOfProcesses / numCpus + 16, algo) == 0;
+	}
+
+	for(i=0; ok && i<numOfProcesses; i++) {
+		t->startTime[i] = -1;
+		t->IsActiveFor[i] = 0;
+		lastCpu[i] = -1;
+	}
+	for(c=0; ok && c<numCpus; c++) {
+		cpu[c].running = cpu[c].preempted = cpu[c].lastRun = IDLE_PROCESS;
+	}
+
+	while(ok && done < numOfProcesses) {
+
+		/*Retire every CPU whose slice ends now*/
+		for(c=0; c<numCpus; c++) {
+			if(cpu[c].running != IDLE_PROCESS && cpu[c].sliceEnd == now) {
+				done += stopRun(t, algo, c, &cpu[c], now, &counters->engine, onRun, arg);
+			}
+		}
+
+		/*Queue arrivals, then processes preempted at this event, behind them unless Round Robin walks past them first*/
+		while(ok && nextArrival < numOfProcesses &&
+				(algo == ALGO_PRIORITY || t->arrivalTime[nextArrival] <= now)) {
+			c = numQueues == 1 ? 0 : leastLoaded(queues, cpu, numCpus);
+			ok = qPush(&queues[c], nextArrival, t->burstTime[nextArrival]) == 0;
+			nextArrival++;
+			PROF_TALLY(counters->engine.queueOps++);
+		}
+		for(c=0; ok && c<numCpus; c++) {
+			if(cpu[c].preempted != IDLE_PROCESS) {
+				p = cpu[c].preempted;
+				ok = qPush(queueOf(queues, sp, c), p, t->burstTime[p]) == 0;
+				cpu[c].preempted = IDLE_PROCESS;
+				PROF_TALLY(counters->engine.queueOps++);
+			}
+		}
+		for(c=0, ready=0; c<numQueues; c++) {
+			ready += queues[c].count;
+		}
+		if(ready > counters->engine.maxQueue) {
+			counters->engine.maxQueue = ready;
+		}
+
+		/*Idle CPUs take work, from another CPU if allowed and their own queue is empty*/
+		for(c=0; ok && c<numCpus; c++) {
+			if(cpu[c].running != IDLE_PROCESS) {
+				continue;
+			}
+			q = queueOf(queues, sp, c);
+			if(q->count > 0) {
+				startRun(t, algo, sp, c, &cpu[c], qPop(q), lastCpu, now, counters, onRun, arg);
+			} else if(sp->balance == BALANCE_STEAL) {
+				victim = 0;
+				for(i=1; i<numCpus; i++) {
+					if(queues[i].count > queues[victim].count) {
+						victim = i;
+					}
+				}
+				if(queues[victim].count > 0) {
+					counters->steals++;
+					startRun(t, algo, sp, c, &cpu[c], qSteal(&queues[victim]), lastCpu, now, counters, onRun, arg);
+				}
+			}
+		}
+
+		/*Shortest Job First: a queued process shorter than a running one preempts it*/
+		while(ok && isSjf) {
+			worst = -1;
+			for(c=0; c<numCpus; c++) {
+				q = queueOf(queues, sp, c);
+				if(cpu[c].running == IDLE_PROCESS || cpu[c].sliceEnd == now || q->count == 0) {
+					continue;
+				}
+				running = onCpu(t, &cpu[c], now);
+				if(!before(qTop(q), &running)) {
+					continue;
+				}
+				/*Per CPU queues preempt their own CPU, the global queue preempts the longest running process*/
+				if(worst < 0 || numQueues > 1 || before(&longest, &running)) {
+					worst = c;
+					longest = running;
+				}
+			}
+			if(worst < 0) {
+				break;
+			}
+			stopRun(t, algo, worst, &cpu[worst], now, &counters->engine, onRun, arg);
+			q = queueOf(queues, sp, worst);
+			startRun(t, algo, sp, worst, &cpu[worst], qPop(q), lastCpu, now, counters, onRun, arg);
+			ok = qPush(q, longest.index, t->burstTime[longest.index]) == 0;
+			cpu[worst].preempted = IDLE_PROCESS;
+		}
+
+		/*Jump to next arrival or end of slice, whichever comes first*/
+		next = -1;
+		if(algo != ALGO_PRIORITY && nextArrival < numOfProcesses) {
+			next = t->arrivalTime[nextArrival];
+		}
+		for(c=0; c<numCpus; c++) {
+			if(cpu[c].running != IDLE_PROCESS && (next < 0 || cpu[c].sliceEnd < next)) {
+				next = cpu[c].sliceEnd;
+			}
+		}
+		if(done < numOfProcesses) {
+			for(c=0, ready=0; c<numQueues; c++) {
+				ready += queues[c].count;
+			}
+			counters->engine.queueArea += ready * (next - now);
+			now = next;
+		}
+	}
+
+	/*Pad every lane with idle time up to the end of the run*/
+	for(c=0; ok && c<numCpus; c++) {
+		if(onRun && now > cpu[c].idleSince) onRun(t, c, IDLE_PROCESS, cpu[c].idleSince, now - cpu[c].idleSince, arg);
+		if(now > cpu[c].idleSince) counters->engine.idleTime += now - cpu[c].idleSince;
+	}
+
+	for(c=0; queues && c<numQueues; c++) {
+		free(queues[c].entry);
+	}
+	free(queues);
+	free(cpu);
+	free(lastCpu);
+	return ok ? now : -1;
+}
@@ -0,0 +1,53 @@
+/*
+ ============================================================================
+ Name        : smp.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Discrete event simulation of several CPUs sharing one
+               workload. Every algorithm of engine.h runs on each CPU;
+               ready queues are either one global queue or one queue per
+               CPU, optionally balanced by work stealing. A process
+               resuming on another CPU than it last ran on costs the CPU
+               migrationCost ticks before it makes progress, on top of
+               switchCost when the CPU ran another process last.
+ ============================================================================
+ */
+
+#ifndef SMP_H_
+#define SMP_H_
+
+#include "engine.h"
+
+/* Load balancing of simulateSmp() */
+enum {
+	BALANCE_GLOBAL,			/* One ready queue shared by all CPUs */
+	BALANCE_PERCPU,			/* Queue per CPU, arrivals go to least loaded CPU and stay there */
+	BALANCE_STEAL			/* As BALANCE_PERCPU, and a CPU out of work steals from the longest queue */
+};
+
+#define MIGRATING_PROCESS -2	/* Process index reported while a CPU pays migration cost */
+
+/*
+ * Called once for every stretch of time a CPU spends on one process.
+ * Arguments are process table, CPU, index of process (IDLE_PROCESS, SWITCHING_PROCESS or MIGRATING_PROCESS),
+ * start time, length.
+ */
+typedef void (*cpuRunCallback)(const procTable *, int, int, simTime, simTime, void *);
+
+typedef struct {
+	int numCpus;
+	int balance;				/* BALANCE_GLOBAL, BALANCE_PERCPU or BALANCE_STEAL */
+	simTime quantum;			/* Round Robin time quantum */
+	simTime migrationCost;		/* Ticks lost when a process resumes on another CPU */
+	simTime switchCost;			/* Ticks lost when a CPU goes from one process to another */
+}smpParams;
+
+typedef struct {
+	long long migrations;		/* Times a process resumed on another CPU */
+	long long steals;			/* Processes taken from queue of another CPU */
+	engineCounters engine;		/* Switches, idle time and queue length of all CPUs */
+}smpCounters;
+
+simTime simulateSmp(procTable *, int, const smpParams *, cpuRunCallback, void *, smpCounters *);	/* As simulate(), on several CPUs */
+
+#endif /* SMP_H_ */
@@ -0,0 +1,188 @@
+/*
+ ============================================================================
+ Name        : sort.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Stable index sorts used by psort() and prioSort()
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "sort.h"
+
+#define RADIX_BITS 11
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_PASSES ((64 + RADIX_BITS - 1) / RADIX_BITS)
+
+/**
+ * Function Name: 	radixSortIndex
+ * Function:		Sorts 64 bit keys in ascending order, moving index array along with them. Stable.
+ * 					One pass over the keys builds histograms of all digits; digits which are the same
+ * 					for every key (e.g. high bits of small times) are skipped
+ * Input:			Keys, index array, number of keys
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Keys and index array
+ */
+
+int radixSortIndex(unsigned long long key[], int order[], int n) {
+	size_t (*count)[RADIX_SIZE];
+	unsigned long long *keyTmp, *keySrc = key, *keyDst, *keySwap;
+	int *orderTmp, *orderSrc = order, *orderDst, *orderSwap;
+	size_t sum, c;
+	int i, pass, digit;
+
+	count = calloc(RADIX_PASSES, sizeof(*count));
+	keyTmp = malloc(n * (sizeof(*keyTmp) + sizeof(*orderTmp)) + 1);
+	if(count == NULL || keyTmp == NULL) {
+		free(count);
+		free(keyTmp);
+		return -1;
+	}
+	orderTmp = (int *)(keyTmp + n);
+	keyDst = keyTmp;
+	orderDst = orderTmp;
+
+	for(i=0; i<n; i++) {
+		for(pass=0; pass<RADIX_PASSES; pass++) {
+			count[pass][(key[i] >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+		}
+	}
+
+	for(pass=0; pass<RADIX_PASSES; pass++) {
+		if(n == 0 || count[pass][(key[0] >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)] == (size_t)n) {
+			continue;					/*Every key has same digit, pass would not change order*/
+		}
+		for(digit=0, sum=0; digit<RADIX_SIZE; digit++) {
+			c = count[pass][digit];
+			count[pass][digit] = sum;
+			sum += c;
+		}
+		for(i=0; i<n; i++) {
+			c = count[pass][(keySrc[i] >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+			keyDst[c] = keySrc[i];
+			orderDst[c] = orderSrc[i];
+		}
+		keySwap = keySrc; keySrc = keyDst; keyDst = keySwap;
+		orderSwap = orderSrc; orderSrc = orderDst; orderDst = orderSwap;
+	}
+
+	if(keySrc != key) {
+		memcpy(key, keySrc, n * sizeof(*key));
+		memcpy(order, orderSrc, n * sizeof(*order));
+	}
+	free(keyTmp);
+	free(count);
+	return 0;
+}
+
+static void mergeRuns(unsigned long long key[], int order[], unsigned long long keyTmp[], int orderTmp[], int n) {
+	int half = n / 2, i, a = 0, b = half;
+
+	if(n < 2) {
+		return;
+	}
+	mergeRuns(key, order, keyTmp, orderTmp, half);
+	mergeRuns(key + half, order + half, keyTmp, orderTmp, n - half);
+	if(key[half - 1] <= key[half]) {
+		return;							/*Already in order, common for traces recorded in arrival order*/
+	}
+	for(i=0; i<n; i++) {
+		if(b >= n || (a < half && key[a] <= key[b])) {	/*<= keeps it stable*/
+			keyTmp[i] = key[a];
+			orderTmp[i] = order[a++];
+		} else {
+			keyTmp[i] = key[b];
+			orderTmp[i] = order[b++];
+		}
+	}
+	memcpy(key, keyTmp, n * sizeof(*key));
+	memcpy(order, orderTmp, n * sizeof(*order));
+}
+
+/**
+ * Function Name: 	mergeSortIndex
+ * Function:		Sorts 64 bit keys in ascending order, moving index array along with them. Stable, O(n log n)
+ * Input:			Keys, index array, number of keys
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Keys and index array
+ */
+
+int mergeSortIndex(unsigned long long key[], int order[], int n) {
+	unsigned long long *keyTmp = malloc(n * (sizeof(*keyTmp) + sizeof(int)) + 1);
+
+	if(keyTmp == NULL) {
+		return -1;
+	}
+	mergeRuns(key, order, keyTmp, (int *)(keyTmp + n), n);
+	free(keyTmp);
+	return 0;
+}
+
+/* Column becomes column[order[0]], column[order[1]], ... */
+#define GATHER(column, tmp, order, n) do {				\
+		int g_;											\
+		for(g_=0; g_<(n); g_++) {						\
+			(tmp)[g_] = (column)[(order)[g_]];			\
+		}												\
+		memcpy((column), (tmp), (n) * sizeof(*(column)));	\
+	} while(0)
+
+/**
+ * Function Name: 	sortProcesses
+ * Function:		Stable sort of process table. Sorts an index array by key, then gathers every
+ * 					column in the new order, one sequential pass per column
+ * Input:			Process table, SORT_BY_ARRIVAL or SORT_BY_PRIORITY_BIT
+ * Output:			0 on success, -1 if out of memory (table left untouched)
+ * Affects:			Process table
+ */
+
+int sortProcesses(procTable *t, int sortBy) {
+	int numOfProcesses = t->numOfProcesses;
+	unsigned long long *key;
+	int *order, i, ret;
+
+	if(numOfProcesses < 2) {
+		return 0;
+	}
+	key = malloc(numOfProcesses * (sizeof(*key) + sizeof(*order)));
+	if(key == NULL) {
+		return -1;
+	}
+	order = (int *)(key + numOfProcesses);
+
+	for(i=0; i<numOfProcesses; i++) {
+		/*Flipping sign bit orders signed values as unsigned, complement makes it descending*/
+		key[i] = (unsigned long long)t->arrivalTime[i] ^ (1ULL << 63);
+		if(sortBy == SORT_BY_PRIORITY_BIT) {
+			key[i] = ~key[i];
+		}
+		order[i] = i;
+	}
+
+	if(numOfProcesses < RADIX_CUTOFF) {
+		ret = mergeSortIndex(key, order, numOfProcesses);
+	} else {
+		ret = radixSortIndex(key, order, numOfProcesses);
+	}
+
+	/*Keys are not needed any more, their buffer is scratch space for gathering*/
+	if(ret == 0) {
+		GATHER(t->arrivalTime, (simTime *)key, order, numOfProcesses);
+		GATHER(t->burstTime, (simTime *)key, order, numOfProcesses);
+		GATHER(t->startTime, (simTime *)key, order, numOfProcesses);
+		GATHER(t->finishTime, (simTime *)key, order, numOfProcesses);
+		GATHER(t->waitingTime, (simTime *)key, order, numOfProcesses);
+		GATHER(t->IsActiveFor, (simTime *)key, order, numOfProcesses);
+		GATHER(t->priority, (int *)key, order, numOfProcesses);
+		GATHER(t->name, (unsigned *)key, order, numOfProcesses);
+		if(t->ioLeft) {
+			GATHER(t->ioLeft, (int *)key, order, numOfProcesses);
+			GATHER(t->nextBurst, (unsigned *)key, order, numOfProcesses);
+			GATHER(t->ioTime, (simTime *)key, order, numOfProcesses);
+		}
+	}
+
+	free(key);
+	return ret;
+}
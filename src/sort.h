@@ -0,0 +1,30 @@
+/*
+ ============================================================================
+ Name        : sort.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Stable ordering of the process table. Keys are sorted
+               together with an index array (LSD radix sort for large
+               tables, merge sort for small ones) and every column of the
+               table is then gathered once in the new order.
+ ============================================================================
+ */
+
+#ifndef SORT_H_
+#define SORT_H_
+
+#include "engine.h"
+
+/* Sort keys understood by sortProcesses() */
+enum {
+	SORT_BY_ARRIVAL,			/* Ascending arrivalTime */
+	SORT_BY_PRIORITY_BIT		/* Descending arrivalTime, which holds priority for the priority algorithm */
+};
+
+#define RADIX_CUTOFF 256		/* Below this many processes merge sort is used */
+
+int sortProcesses(procTable *, int);						/* Stable sort of process table, returns 0 on success */
+int radixSortIndex(unsigned long long *, int *, int);		/* Stable LSD radix sort of keys carrying index array */
+int mergeSortIndex(unsigned long long *, int *, int);		/* Stable merge sort of keys carrying index array */
+
+#endif /* SORT_H_ */
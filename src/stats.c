@@ -0,0 +1,393 @@
+/*
+ ============================================================================
+ Name        : stats.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Run metrics, see stats.h. One pass over the table derives all
+               three metrics of every process, accumulating their sums and
+               maxima with AVX2 or SSE4.2 when the CPU has them, and builds a
+               histogram of the top bits of every metric. The histograms tell
+               which bucket holds each wanted percentile; a second pass only
+               collects the few values of those buckets and the percentile
+               is selected among them. Nothing is sorted and no column sized
+               copy of the table is made. Tables with I/O bursts take the
+               scalar pass, which also derives their I/O wait.
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include <limits.h>
+#include "stats.h"
+#include "profile.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STATS_X86 1
+#include <immintrin.h>
+#endif
+
+#define HIST_BITS 16
+#define HIST_SIZE (1 << HIST_BITS)
+#define NUM_RANKS 3				/* Median, p95, p99 */
+
+enum {TURNAROUND, WAITING, RESPONSE, IO_WAIT, NUM_METRICS};
+
+#define CPU_METRICS IO_WAIT		/* Metrics of every table, IO_WAIT only comes with I/O bursts */
+
+/* Running totals of one metric */
+typedef struct {
+	simTime sum;
+	simTime max;
+	unsigned *count;			/* Histogram, HIST_SIZE buckets */
+}metricAcc;
+
+typedef void (*statsKernel)(const procTable *, const simTime *, int, int, metricAcc *);
+
+static int forceScalar = 0;
+
+void statsForceScalar(int scalar) {
+	forceScalar = scalar;
+}
+
+/* Histogram bucket of a value. Monotonic, so ordering between buckets is exact even when clamped */
+static inline int bucketOf(simTime v, int shift) {
+	if(v < 0) return 0;
+	v >>= shift;
+	return v < HIST_SIZE ? (int)v : HIST_SIZE - 1;
+}
+
+static inline void addValue(metricAcc *m, simTime v, int shift) {
+	m->sum += v;
+	if(v > m->max) m->max = v;
+	m->count[bucketOf(v, shift)]++;
+}
+
+/**
+ * Function Name: 	accumulateScalar
+ * Function:		Derives turnaround, waiting and response time (and I/O wait if the table has I/O bursts) of
+ * 					processes [lo, n) and adds them to the accumulators
+ * Input:			Table, arrival column (NULL when every process arrived at 0), first process, number of processes,
+ * 					histogram shift, accumulators
+ * Output:			None
+ * Affects:			Accumulators
+ */
+
+static void accumulateScalar(const procTable *t, const simTime *arrival, int lo, int n, int shift, metricAcc *acc) {
+	simTime arr, turnaround, io;
+	int i;
+
+	for(i=lo; i<n; i++) {
+		arr = arrival ? arrival[i] : 0;
+		turnaround = t->finishTime[i] - arr;
+		io = t->ioTime ? t->ioTime[i] : 0;
+		addValue(&acc[TURNAROUND], turnaround, shift);
+		addValue(&acc[WAITING], turnaround - t->IsActiveFor[i] - io, shift);
+		addValue(&acc[RESPONSE], t->startTime[i] - arr, shift);
+		if(t->ioTime) {
+			addValue(&acc[IO_WAIT], io, shift);
+		}
+	}
+}
+
+#ifdef STATS_X86
+
+/* Four processes per step. Sums and maxima stay in vector registers, buckets are counted per lane */
+__attribute__((target("avx2")))
+static void accumulateAvx2(const procTable *t, const simTime *arrival, int n, int shift, metricAcc *acc) {
+	__m256i arr = _mm256_setzero_si256(), v[CPU_METRICS], vsum[CPU_METRICS], vmax[CPU_METRICS];
+	simTime lane[4];
+	int i, m, k;
+
+	for(m=0; m<CPU_METRICS; m++) {
+		vsum[m] = _mm256_setzero_si256();
+		vmax[m] = _mm256_set1_epi64x(LLONG_MIN);
+	}
+	for(i=0; i+4<=n; i+=4) {
+		if(arrival) arr = _mm256_loadu_si256((const __m256i *)(arrival + i));
+		v[TURNAROUND] = _mm256_sub_epi64(_mm256_loadu_si256((const __m256i *)(t->finishTime + i)), arr);
+		v[WAITING] = _mm256_sub_epi64(v[TURNAROUND], _mm256_loadu_si256((const __m256i *)(t->IsActiveFor + i)));
+		v[RESPONSE] = _mm256_sub_epi64(_mm256_loadu_si256((const __m256i *)(t->startTime + i)), arr);
+		for(m=0; m<CPU_METRICS; m++) {
+			vsum[m] = _mm256_add_epi64(vsum[m], v[m]);
+			vmax[m] = _mm256_blendv_epi8(vmax[m], v[m], _mm256_cmpgt_epi64(v[m], vmax[m]));
+			_mm256_storeu_si256((__m256i *)lane, v[m]);
+			for(k=0; k<4; k++) {
+				acc[m].count[bucketOf(lane[k], shift)]++;
+			}
+		}
+	}
+	for(m=0; m<CPU_METRICS; m++) {
+		_mm256_storeu_si256((__m256i *)lane, vsum[m]);
+		acc[m].sum += lane[0] + lane[1] + lane[2] + lane[3];
+		_mm256_storeu_si256((__m256i *)lane, vmax[m]);
+		for(k=0; k<4; k++) {
+			if(lane[k] > acc[m].max) acc[m].max = lane[k];
+		}
+	}
+	accumulateScalar(t, arrival, i, n, shift, acc);
+}
+
+/* Two processes per step, 64 bit compare needs SSE4.2 */
+__attribute__((target("sse4.2")))
+static void accumulateSse(const procTable *t, const simTime *arrival, int n, int shift, metricAcc *acc) {
+	__m128i arr = _mm_setzero_si128(), v[CPU_METRICS], vsum[CPU_METRICS], vmax[CPU_METRICS];
+	simTime lane[2];
+	int i, m, k;
+
+	for(m=0; m<CPU_METRICS; m++) {
+		vsum[m] = _mm_setzero_si128();
+		vmax[m] = _mm_set1_epi64x(LLONG_MIN);
+	}
+	for(i=0; i+2<=n; i+=2) {
+		if(arrival) arr = _mm_loadu_si128((const __m128i *)(arrival + i));
+		v[TURNAROUND] = _mm_sub_epi64(_mm_loadu_si128((const __m128i *)(t->finishTime + i)), arr);
+		v[WAITING] = _mm_sub_epi64(v[TURNAROUND], _mm_loadu_si128((const __m128i *)(t->IsActiveFor + i)));
+		v[RESPONSE] = _mm_sub_epi64(_mm_loadu_si128((const __m128i *)(t->startTime + i)), arr);
+		for(m=0; m<CPU_METRICS; m++) {
+			vsum[m] = _mm_add_epi64(vsum[m], v[m]);
+			vmax[m] = _mm_blendv_epi8(vmax[m], v[m], _mm_cmpgt_epi64(v[m], vmax[m]));
+			_mm_storeu_si128((__m128i *)lane, v[m]);
+			for(k=0; k<2; k++) {
+				acc[m].count[bucketOf(lane[k], shift)]++;
+			}
+		}
+	}
+	for(m=0; m<CPU_METRICS; m++) {
+		_mm_storeu_si128((__m128i *)lane, vsum[m]);
+		acc[m].sum += lane[0] + lane[1];
+		_mm_storeu_si128((__m128i *)lane, vmax[m]);
+		for(k=0; k<2; k++) {
+			if(lane[k] > acc[m].max) acc[m].max = lane[k];
+		}
+	}
+	accumulateScalar(t, arrival, i, n, shift, acc);
+}
+
+#endif /* STATS_X86 */
+
+static void accumulatePlain(const procTable *t, const simTime *arrival, int n, int shift, metricAcc *acc) {
+	accumulateScalar(t, arrival, 0, n, shift, acc);
+}
+
+/* Widest kernel this CPU can run on the table */
+static statsKernel pickKernel(const procTable *t) {
+#ifdef STATS_X86
+	if(!forceScalar && t->ioTime == NULL) {
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx2")) return accumulateAvx2;
+		if(__builtin_cpu_supports("sse4.2")) return accumulateSse;
+	}
+#endif
+	return accumulatePlain;
+}
+
+/**
+ * Function Name: 	selectRank
+ * Function:		Moves k-th smallest value to v[k], smaller ones before it and larger ones after it (quickselect)
+ * Input:			Values, range [lo, hi] holding rank k, rank k
+ * Output:			k-th smallest value
+ * Affects:			Order of values
+ */
+
+static simTime selectRank(simTime v[], int lo, int hi, int k) {
+	simTime pivot, tmp;
+	int i, j;
+
+	while(lo < hi) {
+		pivot = v[lo + (hi - lo) / 2];
+		i = lo;
+		j = hi;
+		while(i <= j) {
+			while(v[i] < pivot) i++;
+			while(v[j] > pivot) j--;
+			if(i <= j) {
+				tmp = v[i]; v[i] = v[j]; v[j] = tmp;
+				i++;
+				j--;
+			}
+		}
+		if(k <= j) {
+			hi = j;
+		} else if(k >= i) {
+			lo = i;
+		} else {
+			break;				/*Between the two parts every value equals pivot*/
+		}
+	}
+	return v[k];
+}
+
+/* Nearest rank of given percentile among n values */
+static int rankOf(int percent, int n) {
+	return (int)(((long long)percent * n + 99) / 100) - 1;
+}
+
+/**
+ * Function Name: 	summarizeValues
+ * Function:		Mean, nearest rank percentiles and maximum of values gathered from several runs, for which one
+ * 					histogram cannot be sized in advance. Percentiles are selected in place
+ * Input:			Values, their number, summary to fill
+ * Output:			None
+ * Affects:			Order of values, summary
+ */
+
+void summarizeValues(simTime v[], int n, metricSummary *m) {
+	simTime sum = 0, max;
+	int i;
+
+	*m = (metricSummary){0};
+	if(n <= 0) {
+		return;
+	}
+	max = v[0];
+	for(i=0; i<n; i++) {
+		sum += v[i];
+		if(v[i] > max) max = v[i];
+	}
+	m->mean = (double)sum / n;
+	m->max = max;
+	m->median = selectRank(v, 0, n - 1, rankOf(50, n));
+	m->p95 = selectRank(v, rankOf(50, n), n - 1, rankOf(95, n));
+	m->p99 = selectRank(v, rankOf(95, n), n - 1, rankOf(99, n));
+}
+
+/* Percentile bucket search of one metric */
+typedef struct {
+	int bucket[NUM_RANKS];		/* Histogram bucket holding each rank */
+	int rank[NUM_RANKS];		/* Rank among collected values */
+	simTime *value;				/* Values of those buckets */
+	int collected;
+}rankSearch;
+
+/* Finds bucket of every rank, returns number of values in those buckets */
+static int findBuckets(const unsigned count[], const int rank[NUM_RANKS], rankSearch *rs) {
+	long long below = 0;
+	int b, k = 0, wanted = 0, found;
+
+	for(b=0; b<HIST_SIZE && k<NUM_RANKS; b++) {
+		found = 0;
+		while(k < NUM_RANKS && rank[k] < below + count[b]) {
+			rs->bucket[k] = b;
+			rs->rank[k] = wanted + (int)(rank[k] - below);	/*Values of lower wanted buckets are all smaller*/
+			found = 1;
+			k++;
+		}
+		wanted += found ? count[b] : 0;
+		below += count[b];
+	}
+	return wanted;
+}
+
+static inline void collect(rankSearch *rs, simTime v, int shift) {
+	int b = bucketOf(v, shift);
+
+	if(b == rs->bucket[0] || b == rs->bucket[1] || b == rs->bucket[2]) {
+		rs->value[rs->collected++] = v;
+	}
+}
+
+/* Body of computeStats() */
+static int summarizeRun(const procTable *t, simTime totalTime, int arrivedAtZero, runStats *st) {
+	const simTime *arrival = arrivedAtZero ? NULL : t->arrivalTime;
+	metricSummary *summary[NUM_METRICS] = { &st->turnaround, &st->waiting, &st->response, &st->ioWait };
+	metricAcc acc[NUM_METRICS];
+	rankSearch rs[NUM_METRICS];
+	unsigned *counts;
+	simTime arr, turnaround, io;
+	int n = t->numOfProcesses, metrics = t->ioTime ? NUM_METRICS : CPU_METRICS, rank[NUM_RANKS], shift = 0, exact, i, m;
+	int ret = 0;
+
+	*st = (runStats){{0}};
+	if(n <= 0) {
+		return 0;
+	}
+
+	/*Every metric lies in [0, totalTime], histogram covers that range*/
+	while((totalTime >> shift) >= HIST_SIZE) {
+		shift++;
+	}
+	counts = calloc((size_t)metrics * HIST_SIZE, sizeof(*counts));
+	if(counts == NULL) {
+		return -1;
+	}
+	for(m=0; m<metrics; m++) {
+		acc[m].sum = 0;
+		acc[m].max = LLONG_MIN;
+		acc[m].count = counts + (size_t)m * HIST_SIZE;
+	}
+	pickKernel(t)(t, arrival, n, shift, acc);
+
+	/*When every bucket is one value (no metric was clamped) buckets already are the percentiles*/
+	exact = shift == 0;
+	for(m=0; m<metrics; m++) {
+		if(acc[m].max >= HIST_SIZE) exact = 0;
+	}
+
+	rank[0] = rankOf(50, n);
+	rank[1] = rankOf(95, n);
+	rank[2] = rankOf(99, n);
+	for(m=0; m<metrics; m++) {
+		rs[m].value = malloc(findBuckets(acc[m].count, rank, &rs[m]) * sizeof(simTime));
+		rs[m].collected = 0;
+		if(rs[m].value == NULL) {
+			ret = -1;
+		}
+	}
+
+	if(ret == 0) {
+		for(i=0; i<n && !exact; i++) {
+			arr = arrival ? arrival[i] : 0;
+			turnaround = t->finishTime[i] - arr;
+			io = t->ioTime ? t->ioTime[i] : 0;
+			collect(&rs[TURNAROUND], turnaround, shift);
+			collect(&rs[WAITING], turnaround - t->IsActiveFor[i] - io, shift);
+			collect(&rs[RESPONSE], t->startTime[i] - arr, shift);
+			if(t->ioTime) {
+				collect(&rs[IO_WAIT], io, shift);
+			}
+		}
+		for(m=0; m<metrics; m++) {
+			if(exact) {
+				summary[m]->median = rs[m].bucket[0];
+				summary[m]->p95 = rs[m].bucket[1];
+				summary[m]->p99 = rs[m].bucket[2];
+			} else {
+				/*Each selection leaves larger values above its rank, so next one searches only there*/
+				summary[m]->median = selectRank(rs[m].value, 0, rs[m].collected - 1, rs[m].rank[0]);
+				summary[m]->p95 = selectRank(rs[m].value, rs[m].rank[0], rs[m].collected - 1, rs[m].rank[1]);
+				summary[m]->p99 = selectRank(rs[m].value, rs[m].rank[1], rs[m].collected - 1, rs[m].rank[2]);
+			}
+			summary[m]->mean = (double)acc[m].sum / n;
+			summary[m]->max = acc[m].max;
+		}
+		if(totalTime > 0) {
+			st->throughput = (double)n / totalTime;
+			st->utilization = (double)(acc[TURNAROUND].sum - acc[WAITING].sum - (t->ioTime ? acc[IO_WAIT].sum : 0)) /
+					totalTime;	/*Sum of executed time*/
+		}
+	}
+
+	for(m=0; m<metrics; m++) {
+		free(rs[m].value);
+	}
+	free(counts);
+	return ret;
+}
+
+/**
+ * Function Name: 	computeStats
+ * Function:		Computes waiting, turnaround, response (and I/O wait) summaries, throughput and CPU utilization of
+ * 					a finished run
+ * Input:			Executed process table, time at which run ended, flag telling every process arrived at 0
+ * 					(arrivalTime holds priority), stats to fill
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Stats
+ */
+
+int computeStats(const procTable *t, simTime totalTime, int arrivedAtZero, runStats *st) {
+	int ret;
+
+	PROF_BEGIN(PROF_STATS);
+	ret = summarizeRun(t, totalTime, arrivedAtZero, st);
+	PROF_END(PROF_STATS);
+	return ret;
+}
@@ -0,0 +1,43 @@
+/*
+ ============================================================================
+ Name        : stats.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Aggregate metrics of a finished run computed over the whole
+               process table. For every process
+                   turnaround = finishTime - arrival
+                   waiting    = turnaround - IsActiveFor - ioTime (time
+                                spent ready)
+                   response   = startTime - arrival (WTime of final table)
+                   I/O wait   = ioTime, for tables with I/O bursts
+               Percentiles use nearest rank.
+ ============================================================================
+ */
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include "proctable.h"
+
+typedef struct {
+	double mean;
+	simTime median;
+	simTime p95;
+	simTime p99;
+	simTime max;
+}metricSummary;
+
+typedef struct {
+	metricSummary waiting;
+	metricSummary turnaround;
+	metricSummary response;
+	metricSummary ioWait;		/* Time blocked on I/O, zero for tables without I/O bursts */
+	double throughput;			/* Processes finished per unit of time */
+	double utilization;			/* Fraction of time CPU was busy */
+}runStats;
+
+int computeStats(const procTable *, simTime, int, runStats *);	/* Returns 0 on success, -1 if out of memory */
+void summarizeValues(simTime[], int, metricSummary *);			/* Summary of loose values, which get reordered */
+void statsForceScalar(int);										/* Non-zero disables SSE/AVX2 kernels (benchmarks) */
+
+#endif /* STATS_H_ */
@@ -0,0 +1,318 @@
+/*
+ ============================================================================
+ Name        : stream.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Online discrete event core, see stream.h. The event loop is
+               the one of simulate() with the process table replaced by a
+               pool of live processes and a single process of lookahead:
+               the next arrival is read from the trace only once the one
+               before it has been admitted.
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stream.h"
+
+#define STREAM_INITIAL_SLOTS 64
+
+/* Live processes. Slots of finished ones are handed out again, pool doubles when all are taken */
+typedef struct {
+	streamJob *job;
+	int *freeSlot;				/* Stack of unused slots */
+	int numFree;
+	int size;
+	int live;
+	int peak;
+}jobPool;
+
+typedef struct {
+	simTime key;				/* Remaining burst (Shortest Job First) or round of the walk (Round Robin) */
+	long long seq;
+	int slot;
+}readyEntry;
+
+/*
+ * Ring buffer for FIFO algorithms, binary min-heap on (key, seq) for Shortest Job First and Round Robin, which walks
+ * live processes in arrival order as simulate() does. Doubles when full
+ */
+typedef struct {
+	readyEntry *entry;
+	int head;
+	int count;
+	int size;
+	int isHeap;
+	int isWalk;					/* Round Robin, key is the round */
+	long long round;			/* Round of the process picked last */
+	long long last;				/* seq of the process picked last, -1 before the first pick */
+}readyQueue;
+
+static int before(const readyEntry *a, const readyEntry *b) {
+	return a->key < b->key || (a->key == b->key && a->seq < b->seq);
+}
+
+static void poolInit(jobPool *pool) {
+	pool->size = pool->numFree = pool->live = pool->peak = 0;
+	pool->job = NULL;
+	pool->freeSlot = NULL;
+}
+
+static void poolFree(jobPool *pool) {
+	free(pool->job);
+	free(pool->freeSlot);
+}
+
+/* Takes a free slot, -1 if out of memory */
+static int poolGet(jobPool *pool) {
+	int size = pool->size > 0 ? 2 * pool->size : STREAM_INITIAL_SLOTS, i;
+	streamJob *job;
+	int *freeSlot;
+
+	if(pool->numFree == 0) {
+		job = realloc(pool->job, size * sizeof(streamJob));
+		if(job == NULL) {
+			return -1;
+		}
+		pool->job = job;
+		freeSlot = realloc(pool->freeSlot, size * sizeof(int));
+		if(freeSlot == NULL) {
+			return -1;
+		}
+		pool->freeSlot = freeSlot;
+		for(i=size-1; i>=pool->size; i--) {
+			pool->freeSlot[pool->numFree++] = i;	/*Lowest slot on top*/
+		}
+		pool->size = size;
+	}
+	if(++pool->live > pool->peak) {
+		pool->peak = pool->live;
+	}
+	return pool->freeSlot[--pool->numFree];
+}
+
+static void poolPut(jobPool *pool, int slot) {
+	pool->freeSlot[pool->numFree++] = slot;
+	pool->live--;
+}
+
+static int qInit(readyQueue *q, int algo) {
+	q->size = STREAM_INITIAL_SLOTS;
+	q->head = 0;
+	q->count = 0;
+	q->isWalk = algo == ALGO_RR;
+	q->isHeap = algo == ALGO_SJFP || q->isWalk;
+	q->round = 0;
+	q->last = -1;
+	q->entry = malloc(q->size * sizeof(readyEntry));
+	return q->entry ? 0 : -1;
+}
+
+/* Doubles the queue, unwrapping the ring */
+static int qGrow(readyQueue *q) {
+	readyEntry *grown = malloc(2 * q->size * sizeof(readyEntry));
+	int i;
+
+	if(grown == NULL) {
+		return -1;
+	}
+	for(i=0; i<q->count; i++) {
+		grown[i] = q->entry[(q->head + i) % q->size];
+	}
+	free(q->entry);
+	q->entry = grown;
+	q->head = 0;
+	q->size *= 2;
+	return 0;
+}
+
+static int qPush(readyQueue *q, int slot, const streamJob *job) {
+	readyEntry e = { job->remaining, job->seq, slot };
+	int i, parent;
+
+	if(q->count == q->size && qGrow(q) != 0) {
+		return -1;
+	}
+	if(q->isWalk) {
+		e.key = job->seq > q->last ? q->round : q->round + 1;
+	}
+	if(!q->isHeap) {
+		q->entry[(q->head + q->count++) % q->size] = e;
+		return 0;
+	}
+	for(i=q->count++; i>0; i=parent) {
+		parent = (i - 1) / 2;
+		if(!before(&e, &q->entry[parent])) {
+			break;
+		}
+		q->entry[i] = q->entry[parent];
+	}
+	q->entry[i] = e;
+	return 0;
+}
+
+/* Head of FIFO or smallest entry of heap */
+static readyEntry *qTop(readyQueue *q) {
+	return &q->entry[q->isHeap ? 0 : q->head];
+}
+
+static int qPop(readyQueue *q) {
+	int slot = qTop(q)->slot, i = 0, child;
+	readyEntry last;
+
+	if(q->isWalk) {
+		q->round = qTop(q)->key;
+		q->last = qTop(q)->seq;
+	}
+	if(!q->isHeap) {
+		q->head = (q->head + 1) % q->size;
+		q->count--;
+		return slot;
+	}
+	last = q->entry[--q->count];
+	while((child = 2 * i + 1) < q->count) {
+		if(child + 1 < q->count && before(&q->entry[child + 1], &q->entry[child])) {
+			child++;
+		}
+		if(!before(&q->entry[child], &last)) {
+			break;
+		}
+		q->entry[i] = q->entry[child];
+		i = child;
+	}
+	q->entry[i] = last;
+	return slot;
+}
+
+/* Reads the next arrival into job. 1 if read, 0 at end of trace, -1 on error or arrival out of order */
+static int readJob(traceReader *r, streamJob *job, long long *seq) {
+	simTime arrival;
+	int ret;
+
+	ret = traceNext(r, job->name, sizeof(job->name), &arrival, &job->burstTime, &job->priority);
+	if(ret <= 0) {
+		return ret;
+	}
+	if(*seq > 0 && arrival < job->arrivalTime) {
+		fprintf(stderr, "Process %s arrives at %lld, earlier than the process before it; streaming needs arrival order\n",
+				job->name, arrival);
+		return -1;
+	}
+	job->arrivalTime = arrival;
+	job->remaining = job->burstTime;
+	job->startTime = -1;
+	job->seq = (*seq)++;
+	return 1;
+}
+
+/* Moves pending arrival into pool and ready queue, reading the one after it. Returns what readJob() returns, -1 if out of memory */
+static int admit(traceReader *r, jobPool *pool, readyQueue *rq, streamJob *pending, long long *seq) {
+	int slot = poolGet(pool);
+
+	if(slot < 0 || qPush(rq, slot, pending) != 0) {
+		fprintf(stderr, "Not enough memory for %d live processes\n", pool->live);
+		return -1;
+	}
+	pool->job[slot] = *pending;
+	return readJob(r, pending, seq);
+}
+
+/**
+ * Function Name: 	simulateStream
+ * Function:		Runs a scheduling algorithm online over a trace, reading each process when the clock reaches its
+ * 					arrival. Schedule is the one simulate() gives for the whole trace
+ * Input:			Open trace in arrival order, ALGO_FCFS, ALGO_SJFP or ALGO_RR, time quantum (Round Robin only),
+ * 					callback for every finished process and its argument, result to fill
+ * Output:			0 on success, -1 on bad arguments, malformed or unordered trace, or out of memory (message printed)
+ * Affects:			Trace reader, result
+ */
+
+int simulateStream(traceReader *r, int algo, simTime timeQuanta, streamCallback onDone, void *arg, streamResult *res) {
+	jobPool pool;
+	readyQueue rq;
+	streamJob pending, *job;
+	simTime currentTime = 0, slice;
+	long long seq = 0;
+	int havePending, running;
+
+	memset(res, 0, sizeof(*res));
+	if((algo != ALGO_FCFS && algo != ALGO_SJFP && algo != ALGO_RR) || (algo == ALGO_RR && timeQuanta <= 0)) {
+		fprintf(stderr, "Streaming runs fcfs, sjfp or rr (with a positive quantum)\n");
+		return -1;
+	}
+	poolInit(&pool);
+	if(qInit(&rq, algo) != 0) {
+		fprintf(stderr, "Not enough memory for ready queue\n");
+		return -1;
+	}
+	havePending = readJob(r, &pending, &seq);
+
+	while(havePending > 0 || pool.live > 0) {
+
+		/*Move every process which has arrived by now into ready queue*/
+		while(havePending > 0 && pending.arrivalTime <= currentTime) {
+			havePending = admit(r, &pool, &rq, &pending, &seq);
+		}
+		if(havePending < 0) {
+			break;
+		}
+
+		/*Nothing to run, jump over the idle gap till next arrival*/
+		if(rq.count == 0) {
+			currentTime = pending.arrivalTime;
+			continue;
+		}
+
+		running = algo == ALGO_SJFP ? qTop(&rq)->slot : qPop(&rq);	/*Shortest stays in heap till it finishes*/
+		job = &pool.job[running];
+		if(job->startTime == -1) {
+			job->startTime = currentTime;
+		}
+
+		/*How long can it run before next scheduling decision*/
+		slice = job->remaining;
+		if(algo == ALGO_RR && slice > timeQuanta) {
+			slice = timeQuanta;
+		}
+		if(algo == ALGO_SJFP && havePending > 0 && pending.arrivalTime < currentTime + slice) {
+			slice = pending.arrivalTime - currentTime;	/*Newcomer may be shorter, decide again at its arrival*/
+		}
+		currentTime += slice;
+		job->remaining -= slice;
+
+		if(job->remaining == 0) {
+			job->finishTime = currentTime;
+			res->processes++;
+			res->busyTime += job->burstTime;
+			res->sumWaiting += job->startTime - job->arrivalTime;
+			res->sumTurnaround += currentTime - job->arrivalTime;
+			if(onDone) onDone(job, arg);
+			if(algo == ALGO_SJFP) {
+				qPop(&rq);
+			}
+			poolPut(&pool, running);
+		} else if(algo == ALGO_SJFP) {
+			qTop(&rq)->key = job->remaining;		/*Top only gets smaller, heap stays ordered*/
+		} else {
+			/*Processes arriving during the slice are queued first, the walk decides who runs next*/
+			while(havePending > 0 && pending.arrivalTime <= currentTime) {
+				havePending = admit(r, &pool, &rq, &pending, &seq);
+			}
+			if(havePending < 0) {
+				break;
+			}
+			if(qPush(&rq, running, &pool.job[running]) != 0) {
+				fprintf(stderr, "Not enough memory for %d live processes\n", pool.live);
+				havePending = -1;
+				break;
+			}
+		}
+	}
+
+	res->totalTime = currentTime;
+	res->peakLive = pool.peak;
+	free(rq.entry);
+	poolFree(&pool);
+	return havePending < 0 ? -1 : 0;
+}
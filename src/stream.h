@@ -0,0 +1,52 @@
+/*
+ ============================================================================
+ Name        : stream.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Online scheduling of a trace read as it goes. Processes are
+               taken from a traceReader in arrival order only when the
+               simulated clock reaches them, live ones sit in a pool whose
+               slots are reused, and every finished process is reported
+               and forgotten. Memory depends on the number of processes
+               alive at once, not on length of the trace, so unbounded job
+               logs can be replayed from a pipe. The run ends at end of
+               input once every live process has finished.
+ ============================================================================
+ */
+
+#ifndef STREAM_H_
+#define STREAM_H_
+
+#include "engine.h"
+#include "workload.h"
+
+#define STREAM_NAME_MAX 64		/* Longer names are cut */
+
+/* A live process */
+typedef struct {
+	char name[STREAM_NAME_MAX];
+	simTime arrivalTime;
+	simTime burstTime;			/* Total burst, as read */
+	simTime remaining;
+	simTime startTime;			/* -1 till it first runs */
+	simTime finishTime;
+	long long seq;				/* Position in the trace, breaks ties as process index does in simulate() */
+	int priority;
+}streamJob;
+
+/* Called once for every process as it finishes, the job is reused afterwards */
+typedef void (*streamCallback)(const streamJob *, void *);
+
+typedef struct {
+	long long processes;		/* Finished processes */
+	simTime totalTime;			/* Time at which last process finished */
+	simTime busyTime;			/* Sum of bursts */
+	long long sumWaiting;		/* Sum of time till first run */
+	long long sumTurnaround;
+	int peakLive;				/* Most processes alive at once */
+}streamResult;
+
+int simulateStream(traceReader *, int, simTime, streamCallback, void *, streamResult *);	/* ALGO_FCFS, ALGO_SJFP or ALGO_RR.
+																							   0 on success, -1 on error */
+
+#endif /* STREAM_H_ */
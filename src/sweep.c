@@ -0,0 +1,150 @@
+/*
+ ============================================================================
+ Name        : sweep.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Parameter sweep, see sweep.h
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "sweep.h"
+#include "sched.h"
+#include "sort.h"
+#include "threadpool.h"
+
+/* One run of the sweep */
+typedef struct {
+	workload view;				/* Table sorted as the algorithm needs it, shared read only */
+	sweepResult *result;
+	const sweepSpec *spec;
+}sweepJob;
+
+/* Copies input columns of a table into a new table of the arena */
+static int copyTable(procTable *dst, const procTable *src, arena *mem) {
+	int n = src->numOfProcesses;
+
+	if(arenaInit(mem, n * (PROC_TABLE_BYTES + (src->ioLeft ? PROC_IO_BYTES : 0))) != 0 || procTableInit(dst, mem, n) != 0 ||
+			procTableCopyIo(dst, src, mem) != 0) {
+		return -1;
+	}
+	memcpy(dst->arrivalTime, src->arrivalTime, n * sizeof(simTime));
+	memcpy(dst->burstTime, src->burstTime, n * sizeof(simTime));
+	memcpy(dst->priority, src->priority, n * sizeof(int));
+	memcpy(dst->name, src->name, n * sizeof(unsigned));
+	dst->strings = src->strings;
+	dst->stringsSize = src->stringsSize;
+	return 0;
+}
+
+/* Runs one algorithm of the sweep through sched_run() and keeps its figures */
+static void sweepTask(void *arg) {
+	sweepJob *job = arg;
+	sweepResult *r = job->result;
+	schedParams params = { r->quantum, 1, NULL, NULL };
+	schedResult run;
+
+	params.numCpus = job->spec->numCpus;
+	params.balance = job->spec->balance;
+	params.migrationCost = job->spec->migrationCost;
+	params.switchCost = job->spec->switchCost;
+
+	if(sched_run(r->algo, &job->view, &params, &run) != 0) {
+		r->failed = 1;
+	} else {
+		r->avgWaiting = run.avgWaiting;
+		r->avgTurnaround = run.avgTurnaround;
+		r->contextSwitches = run.contextSwitches;
+		r->preemptions = run.preemptions;
+		r->switchTime = run.switchTime;
+		r->totalTime = run.totalTime;
+	}
+	sched_result_free(&run);
+}
+
+/* Copy of the workload sorted for the Priority algorithm, which keeps priority in arrivalTime */
+static int priorityOrder(procTable *t, const workload *wl, arena *mem) {
+	int i;
+
+	if(copyTable(t, &wl->table, mem) != 0) {
+		return -1;
+	}
+	if(wl->hasPriority) {
+		for(i=0; i<t->numOfProcesses; i++) {
+			t->arrivalTime[i] = t->priority[i];
+		}
+	}
+	return sortProcesses(t, SORT_BY_PRIORITY_BIT);
+}
+
+/**
+ * Function Name: 	runSweep
+ * Function:		Sorts the workload once per ordering, then runs every algorithm and quantum of the sweep in parallel
+ * Input:			Loaded workload, sweep, pointers receiving result array and its length
+ * Output:			0 on success, -1 if out of memory or threads cannot be started
+ * Affects:			Nothing in the workload
+ */
+
+int runSweep(const workload *wl, const sweepSpec *spec, sweepResult **results, int *count) {
+	procTable byArrival, byPriority;
+	arena arrivalMem, priorityMem;
+	threadPool pool;
+	sweepJob *job;
+	sweepResult *r;
+	simTime q;
+	int numJobs = 0, i, ok;
+
+	for(q=spec->minQuantum; q<=spec->maxQuantum; q+=spec->step) {
+		numJobs++;
+	}
+	numJobs += spec->allAlgorithms ? 3 : 0;
+	r = calloc(numJobs + 1, sizeof(sweepResult));
+	job = calloc(numJobs + 1, sizeof(sweepJob));
+
+	/*Orderings are shared by all runs, each run copies and simulates*/
+	arrivalMem.current = priorityMem.current = NULL;
+	ok = r != NULL && job != NULL && copyTable(&byArrival, &wl->table, &arrivalMem) == 0 &&
+			sortProcesses(&byArrival, SORT_BY_ARRIVAL) == 0;
+	if(ok && spec->allAlgorithms) {
+		ok = priorityOrder(&byPriority, wl, &priorityMem) == 0;
+	}
+
+	if(ok) {
+		numJobs = 0;
+		if(spec->allAlgorithms) {
+			r[numJobs].algo = ALGO_FCFS;
+			job[numJobs++].view.table = byArrival;
+			r[numJobs].algo = ALGO_SJFP;
+			job[numJobs++].view.table = byArrival;
+			r[numJobs].algo = ALGO_PRIORITY;
+			job[numJobs++].view.table = byPriority;	/*Priority already moved into arrivalTime*/
+		}
+		for(q=spec->minQuantum; q<=spec->maxQuantum; q+=spec->step) {
+			r[numJobs].algo = ALGO_RR;
+			r[numJobs].quantum = q;
+			job[numJobs++].view.table = byArrival;
+		}
+		ok = poolInit(&pool, spec->numThreads) == 0;
+	}
+
+	if(ok) {
+		for(i=0; i<numJobs; i++) {
+			job[i].result = &r[i];
+			job[i].spec = spec;
+			if(poolSubmit(&pool, sweepTask, &job[i]) != 0) {
+				r[i].failed = 1;
+			}
+		}
+		poolWait(&pool);
+		poolDestroy(&pool);
+		*results = r;
+		*count = numJobs;
+	} else {
+		free(r);
+	}
+	arenaFree(&arrivalMem);
+	arenaFree(&priorityMem);
+	free(job);
+	return ok ? 0 : -1;
+}
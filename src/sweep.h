@@ -0,0 +1,45 @@
+/*
+ ============================================================================
+ Name        : sweep.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Parameter sweep. Runs Round Robin over a range of time quanta,
+               and optionally the other algorithms once, against the same
+               workload. Runs go in parallel on a work stealing thread pool;
+               every run works on its own copy of the process table in its
+               own arena, so they share nothing but the loaded workload.
+ ============================================================================
+ */
+
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+#include "workload.h"
+
+typedef struct {
+	simTime minQuantum;
+	simTime maxQuantum;
+	simTime step;
+	int allAlgorithms;			/* Also run FCFS, SJF and Priority once each */
+	int numThreads;				/* 0 = one per CPU */
+	int numCpus;				/* Simulated CPUs of every run, see schedParams */
+	int balance;
+	simTime migrationCost;
+	simTime switchCost;			/* Ticks per context switch of every run */
+}sweepSpec;
+
+typedef struct {
+	int algo;
+	simTime quantum;			/* Round Robin only */
+	double avgWaiting;			/* Same definitions as final table: WTime */
+	double avgTurnaround;		/* and TATime */
+	long long contextSwitches;	/* Times CPU went from one process to another */
+	long long preemptions;		/* Switches away from an unfinished process */
+	simTime switchTime;			/* Ticks spent switching */
+	simTime totalTime;
+	int failed;					/* Run was out of memory */
+}sweepResult;
+
+int runSweep(const workload *, const sweepSpec *, sweepResult **, int *);	/* Results in run order, caller frees. 0 on success */
+
+#endif /* SWEEP_H_ */
@@ -0,0 +1,113 @@
+/*
+ ============================================================================
+ Name        : synth.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Synthetic workload generator, see synth.h
+ ============================================================================
+ */
+
+#include <string.h>
+#include <math.h>
+#include "synth.h"
+
+#define MEAN_BURST 10
+#define MEAN_GAP 11
+#define PARETO_ALPHA 1.5
+#define MAX_BURST 100000		/* Caps Pareto tail so one job cannot swamp a small run */
+#define BURST_LENGTH 50			/* Mean number of jobs arriving together in SYNTH_BURSTY */
+#define IO_CPU_BURSTS 5			/* CPU bursts of a SYNTH_IO job, I/O bursts go between them */
+#define MEAN_IO 1000000			/* Mean I/O burst of SYNTH_IO */
+
+const char *const synthName[SYNTH_KINDS] = { "uniform", "pareto", "bursty", "io" };
+
+/* xorshift64* generator, state lives with the caller */
+static unsigned long long nextRandom(unsigned long long *state) {
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 2685821657736338717ULL;
+}
+
+/* Uniform in (0, 1] */
+static double unitRandom(unsigned long long *state) {
+	return ((nextRandom(state) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+static simTime exponential(unsigned long long *state, double mean) {
+	return (simTime)(-log(unitRandom(state)) * mean);
+}
+
+/**
+ * Function Name: 	synthWorkload
+ * Function:		Fills a workload with generated processes, already in arrival order. Every process is
+ * 					named "J" and gets a random priority 0..9
+ * Input:			Workload, arena of the run (created here), kind, number of processes, seed
+ * Output:			0 on success, -1 if out of memory or kind is unknown
+ * Affects:			Arena, workload
+ */
+
+int synthWorkload(workload *wl, arena *runArena, int kind, int numOfProcesses, unsigned long long seed) {
+	procTable *t = &wl->table;
+	unsigned long long state = seed * 0x9E3779B97F4A7C15ULL + 1;
+	double xm = MEAN_BURST * (PARETO_ALPHA - 1) / PARETO_ALPHA;	/*Pareto scale giving mean MEAN_BURST*/
+	size_t pairs = 2 * (IO_CPU_BURSTS - 1);
+	simTime now = 0, burst, *bursts = NULL;
+	int i, k;
+
+	memset(wl, 0, sizeof(*wl));
+	if(kind < 0 || kind >= SYNTH_KINDS || arenaInit(runArena, numOfProcesses * (PROC_TABLE_BYTES + (kind == SYNTH_IO ?
+			PROC_IO_BYTES + pairs * sizeof(simTime) : 0)) + 16) != 0 || procTableInit(t, runArena, numOfProcesses) != 0) {
+		return -1;
+	}
+	if(kind == SYNTH_IO) {
+		bursts = arenaAlloc(runArena, numOfProcesses * pairs * sizeof(simTime) + 1);
+		if(bursts == NULL || procTableInitIo(t, runArena) != 0) {
+			return -1;
+		}
+		t->bursts = bursts;
+		t->numBursts = numOfProcesses * pairs;
+	}
+	t->strings = "J";
+	t->stringsSize = 2;
+	wl->hasPriority = 1;
+
+	for(i=0; i<numOfProcesses; i++) {
+		switch(kind) {
+			case SYNTH_UNIFORM:
+				now += nextRandom(&state) % (2 * MEAN_GAP + 1);
+				burst = 1 + nextRandom(&state) % (2 * MEAN_BURST - 1);
+				break;
+			case SYNTH_PARETO:
+				now += exponential(&state, MEAN_GAP);
+				burst = (simTime)ceil(xm / pow(unitRandom(&state), 1 / PARETO_ALPHA));
+				if(burst > MAX_BURST) burst = MAX_BURST;
+				break;
+			case SYNTH_IO:
+				/*CPU bursts add up to MEAN_BURST on average, as for the other kinds*/
+				now += exponential(&state, MEAN_GAP);
+				burst = 1 + nextRandom(&state) % (2 * MEAN_BURST / IO_CPU_BURSTS - 1);
+				t->ioLeft[i] = IO_CPU_BURSTS - 1;
+				t->nextBurst[i] = (unsigned)(i * pairs);
+				for(k=0; k<(int)pairs; k+=2) {
+					bursts[i * pairs + k] = exponential(&state, MEAN_IO);
+					bursts[i * pairs + k + 1] = 1 + nextRandom(&state) % (2 * MEAN_BURST / IO_CPU_BURSTS - 1);
+				}
+				break;
+			default:
+				/*Each burst of arrivals is followed by a quiet gap keeping the same mean rate*/
+				if(nextRandom(&state) % BURST_LENGTH == 0) {
+					now += exponential(&state, MEAN_GAP * BURST_LENGTH);
+				} else {
+					now += exponential(&state, 1);
+				}
+				burst = 1 + nextRandom(&state) % (2 * MEAN_BURST - 1);
+				break;
+		}
+		t->arrivalTime[i] = now;
+		t->burstTime[i] = burst;
+		t->priority[i] = nextRandom(&state) % 10;
+		t->name[i] = 0;
+	}
+	return 0;
+}
@@ -0,0 +1,33 @@
+/*
+ ============================================================================
+ Name        : synth.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Synthetic workloads for benchmarks. Every kind keeps the CPU
+               about 90% loaded (mean burst 10, mean gap 11 ticks):
+                   SYNTH_UNIFORM  uniform gaps and bursts
+                   SYNTH_PARETO   Poisson arrivals, heavy tailed Pareto
+                                  bursts (alpha 1.5)
+                   SYNTH_BURSTY   arrivals in Poisson bursts separated by
+                                  long quiet gaps, uniform bursts
+                   SYNTH_IO       Poisson arrivals, five short uniform CPU
+                                  bursts with long exponential I/O bursts
+                                  between them, so that with a million jobs
+                                  hundreds of thousands are blocked at once
+               Generation is deterministic for a seed and uses no global
+               state, so it may run on several threads.
+ ============================================================================
+ */
+
+#ifndef SYNTH_H_
+#define SYNTH_H_
+
+#include "workload.h"
+
+enum {SYNTH_UNIFORM, SYNTH_PARETO, SYNTH_BURSTY, SYNTH_IO, SYNTH_KINDS};
+
+extern const char *const synthName[SYNTH_KINDS];
+
+int synthWorkload(workload *, arena *, int, int, unsigned long long);	/* Kind, number of processes, seed. 0 on success */
+
+#endif /* SYNTH_H_ */
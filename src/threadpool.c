@@ -0,0 +1,266 @@
+/*
+ ============================================================================
+ Name        : threadpool.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Work stealing thread pool, see threadpool.h
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "threadpool.h"
+
+#define DEQUE_INITIAL 16
+
+/* Pool and index of worker running on this thread, so nested submits stay local */
+static __thread threadPool *currentPool = NULL;
+static __thread int currentWorker = -1;
+
+typedef struct {
+	threadPool *pool;
+	int id;
+}workerArg;
+
+int numCpus(void) {
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+}
+
+static int dequePush(workDeque *d, task t) {
+	task *grown;
+	int i;
+
+	pthread_mutex_lock(&d->lock);
+	if(d->count == d->capacity) {
+		grown = malloc(2 * d->capacity * sizeof(task));
+		if(grown == NULL) {
+			pthread_mutex_unlock(&d->lock);
+			return -1;
+		}
+		for(i=0; i<d->count; i++) {
+			grown[i] = d->slot[(d->head + i) % d->capacity];
+		}
+		free(d->slot);
+		d->slot = grown;
+		d->head = 0;
+		d->capacity *= 2;
+	}
+	d->slot[(d->head + d->count) % d->capacity] = t;
+	d->count++;
+	pthread_mutex_unlock(&d->lock);
+	return 0;
+}
+
+/* Newest task, taken by owner */
+static int dequePopTail(workDeque *d, task *t) {
+	int ok = 0;
+
+	pthread_mutex_lock(&d->lock);
+	if(d->count > 0) {
+		d->count--;
+		*t = d->slot[(d->head + d->count) % d->capacity];
+		ok = 1;
+	}
+	pthread_mutex_unlock(&d->lock);
+	return ok;
+}
+
+/* Oldest task, taken by thieves */
+static int dequeStealHead(workDeque *d, task *t) {
+	int ok = 0;
+
+	pthread_mutex_lock(&d->lock);
+	if(d->count > 0) {
+		*t = d->slot[d->head];
+		d->head = (d->head + 1) % d->capacity;
+		d->count--;
+		ok = 1;
+	}
+	pthread_mutex_unlock(&d->lock);
+	return ok;
+}
+
+/* Own deque first, then steal going round the other workers */
+static int takeTask(threadPool *pool, int id, task *t) {
+	int i;
+
+	if(dequePopTail(&pool->deque[id], t)) {
+		return 1;
+	}
+	for(i=1; i<pool->numWorkers; i++) {
+		if(dequeStealHead(&pool->deque[(id + i) % pool->numWorkers], t)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void *worker(void *arg) {
+	workerArg *wa = arg;
+	threadPool *pool = wa->pool;
+	int id = wa->id;
+	task t;
+
+	free(wa);
+	currentPool = pool;
+	currentWorker = id;
+	for(;;) {
+		if(takeTask(pool, id, &t)) {
+			pthread_mutex_lock(&pool->lock);
+			pool->queued--;
+			pthread_mutex_unlock(&pool->lock);
+
+			t.func(t.arg);
+
+			pthread_mutex_lock(&pool->lock);
+			if(--pool->pending == 0) {
+				pthread_cond_broadcast(&pool->allDone);
+			}
+			pthread_mutex_unlock(&pool->lock);
+			continue;
+		}
+
+		/*Queued may briefly go negative when a task is taken before its submitter counted it*/
+		pthread_mutex_lock(&pool->lock);
+		while(pool->queued <= 0 && !pool->stopping) {
+			pthread_cond_wait(&pool->workReady, &pool->lock);
+		}
+		if(pool->stopping && pool->queued <= 0) {
+			pthread_mutex_unlock(&pool->lock);
+			break;
+		}
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return NULL;
+}
+
+/**
+ * Function Name: 	poolInit
+ * Function:		Creates deques and starts workers
+ * Input:			Pool, number of workers (0 or less for one per CPU)
+ * Output:			0 on success, -1 if out of memory or threads cannot be created
+ * Affects:			Pool
+ */
+
+int poolInit(threadPool *pool, int numWorkers) {
+	workerArg *wa;
+	int i;
+
+	memset(pool, 0, sizeof(*pool));
+	pool->numWorkers = numWorkers > 0 ? numWorkers : numCpus();
+	pool->thread = calloc(pool->numWorkers, sizeof(pthread_t));
+	pool->deque = calloc(pool->numWorkers, sizeof(workDeque));
+	if(pool->thread == NULL || pool->deque == NULL) {
+		free(pool->thread);
+		free(pool->deque);
+		return -1;
+	}
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->workReady, NULL);
+	pthread_cond_init(&pool->allDone, NULL);
+	for(i=0; i<pool->numWorkers; i++) {
+		pthread_mutex_init(&pool->deque[i].lock, NULL);
+		pool->deque[i].capacity = DEQUE_INITIAL;
+		pool->deque[i].slot = malloc(DEQUE_INITIAL * sizeof(task));
+		if(pool->deque[i].slot == NULL) {
+			pool->numWorkers = i + 1;		/*Only these get joined and freed*/
+			poolDestroy(pool);
+			return -1;
+		}
+	}
+	for(i=0; i<pool->numWorkers; i++) {
+		wa = malloc(sizeof(*wa));
+		if(wa == NULL) {
+			poolDestroy(pool);			/*Joins only threads already created*/
+			return -1;
+		}
+		wa->pool = pool;
+		wa->id = i;
+		if(pthread_create(&pool->thread[i], NULL, worker, wa) != 0) {
+			free(wa);
+			pool->thread[i] = 0;
+			poolDestroy(pool);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Function Name: 	poolSubmit
+ * Function:		Queues a task. From inside a task it goes to deque of current worker,
+ * 					otherwise deques are filled in turn
+ * Input:			Pool, task function, its argument
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Pool
+ */
+
+int poolSubmit(threadPool *pool, taskFunc func, void *arg) {
+	task t;
+	int target;
+
+	t.func = func;
+	t.arg = arg;
+	pthread_mutex_lock(&pool->lock);
+	if(currentPool == pool) {
+		target = currentWorker;
+	} else {
+		target = pool->nextDeque;
+		pool->nextDeque = (pool->nextDeque + 1) % pool->numWorkers;
+	}
+	pool->pending++;
+	pthread_mutex_unlock(&pool->lock);
+
+	if(dequePush(&pool->deque[target], t) != 0) {
+		pthread_mutex_lock(&pool->lock);
+		if(--pool->pending == 0) {
+			pthread_cond_broadcast(&pool->allDone);
+		}
+		pthread_mutex_unlock(&pool->lock);
+		return -1;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	pool->queued++;
+	pthread_cond_signal(&pool->workReady);
+	pthread_mutex_unlock(&pool->lock);
+	return 0;
+}
+
+void poolWait(threadPool *pool) {
+	pthread_mutex_lock(&pool->lock);
+	while(pool->pending > 0) {
+		pthread_cond_wait(&pool->allDone, &pool->lock);
+	}
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/* Lets tasks keep per worker state, such as an arena, without locking */
+int poolWorker(const threadPool *pool) {
+	return currentPool == pool ? currentWorker : -1;
+}
+
+void poolDestroy(threadPool *pool) {
+	int i;
+
+	pthread_mutex_lock(&pool->lock);
+	pool->stopping = 1;
+	pthread_cond_broadcast(&pool->workReady);
+	pthread_mutex_unlock(&pool->lock);
+	for(i=0; i<pool->numWorkers; i++) {
+		if(pool->thread[i]) {
+			pthread_join(pool->thread[i], NULL);
+		}
+		free(pool->deque[i].slot);
+		pthread_mutex_destroy(&pool->deque[i].lock);
+	}
+	pthread_cond_destroy(&pool->allDone);
+	pthread_cond_destroy(&pool->workReady);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool->thread);
+	free(pool->deque);
+	pool->thread = NULL;
+	pool->deque = NULL;
+}
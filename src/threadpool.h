@@ -0,0 +1,55 @@
+/*
+ ============================================================================
+ Name        : threadpool.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Work stealing thread pool. Every worker has its own deque of
+               tasks; it runs its newest task first and, when it has none
+               left, steals the oldest task of another worker. Tasks
+               submitted from inside a task go to the deque of the worker
+               running it.
+ ============================================================================
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <pthread.h>
+
+typedef void (*taskFunc)(void *);
+
+typedef struct {
+	taskFunc func;
+	void *arg;
+}task;
+
+/* Tasks of one worker. Owner takes from tail, thieves from head */
+typedef struct {
+	pthread_mutex_t lock;
+	task *slot;
+	int head;
+	int count;
+	int capacity;
+}workDeque;
+
+typedef struct {
+	pthread_t *thread;
+	workDeque *deque;
+	int numWorkers;
+	pthread_mutex_t lock;		/* Guards the fields below */
+	pthread_cond_t workReady;
+	pthread_cond_t allDone;
+	int queued;					/* Tasks waiting in deques */
+	int pending;				/* Tasks submitted and not yet finished */
+	int nextDeque;				/* Deque for next task submitted from outside the pool */
+	int stopping;
+}threadPool;
+
+int poolInit(threadPool *, int);				/* Starts given number of workers (0 = one per CPU), returns 0 on success */
+int poolSubmit(threadPool *, taskFunc, void *);	/* Queues a task, returns 0 on success */
+void poolWait(threadPool *);					/* Waits till every submitted task has finished */
+void poolDestroy(threadPool *);					/* Stops and joins workers */
+int poolWorker(const threadPool *);				/* Index of worker calling it, -1 outside the pool */
+int numCpus(void);								/* Number of online CPUs, at least 1 */
+
+#endif /* THREADPOOL_H_ */
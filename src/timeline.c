@@ -0,0 +1,247 @@
+/*
+ ============================================================================
+ Name        : timeline.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Run-length encoded timeline and Gantt chart printer
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "timeline.h"
+#include "smp.h"
+
+/**
+ * Function Name: 	timelineInit
+ * Function:		Creates empty timeline inside the arena of the run
+ * Input:			Timeline, arena, expected number of segments
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Timeline, arena
+ */
+
+int timelineInit(timeline *tl, arena *mem, int capacity) {
+	if(capacity < 1) {
+		capacity = 1;
+	}
+	tl->mem = mem;
+	tl->count = 0;
+	tl->capacity = capacity;
+	tl->seg = arenaAlloc(mem, capacity * sizeof(segment));
+	return tl->seg ? 0 : -1;
+}
+
+/* Adds a segment after the last one, growing storage when full */
+static int addSegment(timeline *tl, int process, simTime start, simTime length) {
+	segment *grown;
+
+	if(tl->count == tl->capacity) {
+		grown = arenaAlloc(tl->mem, 2 * tl->capacity * sizeof(segment));
+		if(grown == NULL) {
+			return -1;
+		}
+		memcpy(grown, tl->seg, tl->count * sizeof(segment));
+		tl->seg = grown;
+		tl->capacity *= 2;
+	}
+	tl->seg[tl->count].process = process;
+	tl->seg[tl->count].start = start;
+	tl->seg[tl->count].length = length;
+	tl->count++;
+	return 0;
+}
+
+/**
+ * Function Name: 	timelineAppend
+ * Function:		Records that process ran (or CPU was idle) from start for length ticks. A run continuing
+ * 					previous segment of same process only extends it. Storage doubles when full.
+ * Input:			Timeline, process index or IDLE_PROCESS, start time, length
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Timeline, arena
+ */
+
+int timelineAppend(timeline *tl, int process, simTime start, simTime length) {
+	segment *last;
+
+	if(length <= 0) {
+		return 0;
+	}
+	if(tl->count > 0) {
+		last = &tl->seg[tl->count - 1];
+		if(last->process == process && last->start + last->length == start) {
+			last->length += length;
+			return 0;
+		}
+	}
+	return addSegment(tl, process, start, length);
+}
+
+/* Label of a segment in Gantt chart, "--" marks idle CPU, "><" context switch, "<>" migration cost and
+   "**" a window column shared by several segments */
+static const char *segmentLabel(const segment *seg, const procTable *t) {
+	if(seg->process == IDLE_PROCESS) {
+		return "--";
+	}
+	if(seg->process == MIXED_SEGMENT) {
+		return "**";
+	}
+	if(seg->process == SWITCHING_PROCESS) {
+		return "><";
+	}
+	return seg->process == MIGRATING_PROCESS ? "<>" : PROC_NAME(t, seg->process);
+}
+
+/* Bar of process names over time axis at every context switch. Columns are 7 wide unless a name or time needs more */
+static void printBar(const timeline *tl, const procTable *t) {
+	char time[24];
+	int i, width = 7, len;
+	simTime end = 0;
+
+	for(i=0; i<tl->count; i++) {
+		len = (int)strlen(segmentLabel(&tl->seg[i], t)) + 1;
+		if(len > width) width = len;
+		len = snprintf(time, sizeof(time), "%lld", tl->seg[i].start + tl->seg[i].length) + 1;
+		if(len > width) width = len;
+	}
+	for(i=0; i<tl->count; i++) {
+		printf("|%-*s", width - 1, segmentLabel(&tl->seg[i], t));
+	}
+	printf("|\n");
+
+	for(i=0; i<tl->count; i++) {
+		printf("%-*lld", width, tl->seg[i].start);
+		end = tl->seg[i].start + tl->seg[i].length;
+	}
+	printf("%lld\n", end);
+}
+
+/**
+ * Function Name: 	timelinePrint
+ * Function:		Prints Gantt chart with one column per segment and its start time below it.
+ * 					Work is proportional to number of context switches, not to length of run.
+ * Input:			Timeline, process table
+ * Output:			None
+ * Affects:			Nothing
+ */
+
+void timelinePrint(const timeline *tl, const procTable *t) {
+	printf("Gantt Chart:\n");
+	printBar(tl, t);
+}
+
+/**
+ * Function Name: 	timelinePrintLanes
+ * Function:		Prints Gantt chart of a run on several CPUs, one lane per CPU. A single lane is printed
+ * 					exactly as timelinePrint() does
+ * Input:			Array of timelines (one per CPU), number of CPUs, process table
+ * Output:			None
+ * Affects:			Nothing
+ */
+
+void timelinePrintLanes(const timeline *lanes, int numCpus, const procTable *t) {
+	int c;
+
+	if(numCpus <= 1) {
+		timelinePrint(lanes, t);
+		return;
+	}
+	printf("Gantt Chart:\n");
+	for(c=0; c<numCpus; c++) {
+		printf("CPU %d\n", c);
+		printBar(&lanes[c], t);
+	}
+}
+
+/* Binary search, segments of a timeline are recorded in time order */
+int timelineFind(const timeline *tl, simTime time) {
+	int lo = 0, hi = tl->count - 1, mid, found = -1;
+
+	while(lo <= hi) {
+		mid = lo + (hi - lo) / 2;
+		if(tl->seg[mid].start <= time) {
+			found = mid;
+			lo = mid + 1;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	return found;
+}
+
+/**
+ * Function Name: 	timelineWindow
+ * Function:		Resamples [from, to) of a timeline into columns of equal width (at least one tick). A segment
+ * 					covering more than half of a column must hold its middle, so one binary search per column finds
+ * 					it; without one the column is MIXED_SEGMENT, or IDLE_PROCESS when nothing was recorded there.
+ * 					Every column is a segment of its own, even next to one of the same label, so each one spans
+ * 					the width printed in the chart header
+ * Input:			Timeline, start and end of window, number of columns, empty timeline receiving the window
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Window timeline
+ * NOTES:			Work is proportional to columns times log of segments, whatever the length of the window.
+ */
+
+int timelineWindow(const timeline *tl, simTime from, simTime to, int columns, timeline *window) {
+	const segment *s;
+	simTime width, col, end, mid, overlap;
+	int i, label;
+
+	if(to <= from || columns < 1) {
+		return 0;
+	}
+	width = (to - from + columns - 1) / columns;
+	for(col=from; col<to; col+=width) {
+		end = to - col > width ? col + width : to;
+		mid = col + (end - col) / 2;
+		i = timelineFind(tl, mid);
+		s = i >= 0 ? &tl->seg[i] : NULL;
+		if(s && s->start + s->length > mid) {
+			overlap = (s->start + s->length < end ? s->start + s->length : end) - (s->start > col ? s->start : col);
+			label = 2 * overlap > end - col ? s->process : MIXED_SEGMENT;
+		} else {
+			/*Middle falls in a gap, column is mixed if a segment reaches into it from either side*/
+			label = (s && s->start + s->length > col) || (i + 1 < tl->count && tl->seg[i + 1].start < end) ?
+					MIXED_SEGMENT : IDLE_PROCESS;
+		}
+		if(addSegment(window, label, col, end - col) != 0) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Function Name: 	timelinePrintWindow
+ * Function:		Prints Gantt chart of [from, to) of a run on one or more CPUs in at most the given number of
+ * 					columns per lane, see timelineWindow()
+ * Input:			Array of timelines (one per CPU), number of CPUs, process table, start and end of window,
+ * 					number of columns
+ * Output:			0 on success, -1 if out of memory
+ * Affects:			Nothing
+ */
+
+int timelinePrintWindow(const timeline *lanes, int numCpus, const procTable *t, simTime from, simTime to, int columns) {
+	arena mem;
+	timeline window;
+	int c, ret = 0;
+
+	if(columns < 1 || arenaInit(&mem, columns * sizeof(segment)) != 0) {
+		return -1;
+	}
+	printf("Gantt Chart, ticks %lld to %lld, %lld per column:\n", from, to,
+			to > from ? (to - from + columns - 1) / columns : 0);
+	for(c=0; c<numCpus && ret == 0; c++) {
+		if(timelineInit(&window, &mem, columns) != 0 || timelineWindow(&lanes[c], from, to, columns, &window) != 0) {
+			ret = -1;
+			break;
+		}
+		if(numCpus > 1) {
+			printf("CPU %d\n", c);
+		}
+		if(window.count > 0) {
+			printBar(&window, t);
+		}
+	}
+	arenaFree(&mem);
+	return ret;
+}
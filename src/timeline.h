@@ -0,0 +1,48 @@
+/*
+ ============================================================================
+ Name        : timeline.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Run-length encoded record of what the CPU did, used for Gantt
+               chart. One segment per stretch of contiguous execution (or
+               idle time) instead of one entry per tick.
+               A chart of a long run can also be drawn for a window of it at
+               a given number of columns. Each column is found by binary
+               search and shows the segment covering more than half of it, or
+               "**" when several share it, so drawing costs the same for any
+               window of any run.
+ ============================================================================
+ */
+
+#ifndef TIMELINE_H_
+#define TIMELINE_H_
+
+#include "engine.h"
+#include "arena.h"
+
+#define MIXED_SEGMENT -4			/* Window column no segment covers more than half of */
+
+typedef struct {
+	int process;				/* Index in process table, IDLE_PROCESS when CPU is idle (MIGRATING_PROCESS in smp.h) */
+	simTime start;
+	simTime length;
+}segment;
+
+typedef struct {
+	segment *seg;
+	int count;
+	int capacity;
+	arena *mem;					/* Segments grow inside the arena of the run */
+}timeline;
+
+int timelineInit(timeline *, arena *, int);				/* Reserves room for given number of segments, returns 0 on success */
+int timelineAppend(timeline *, int, simTime, simTime);	/* Records a run, merging it with previous segment when contiguous */
+void timelinePrint(const timeline *, const procTable *);	/* Prints Gantt chart, one column per segment */
+void timelinePrintLanes(const timeline *, int, const procTable *);	/* Prints Gantt chart of every CPU, one lane each */
+int timelineFind(const timeline *, simTime);			/* Index of last segment starting at or before given time, -1 if none */
+int timelineWindow(const timeline *, simTime, simTime, int, timeline *);	/* Source, from, to, columns, empty timeline to fill.
+																			   0 on success, -1 if out of memory */
+int timelinePrintWindow(const timeline *, int, const procTable *, simTime, simTime, int);	/* Lanes, CPUs, table, from, to,
+																							   columns. 0 on success */
+
+#endif /* TIMELINE_H_ */
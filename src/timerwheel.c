@@ -0,0 +1,179 @@
+/*
+ ============================================================================
+ Name        : timerwheel.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Hierarchical timer wheel, see timerwheel.h. An entry at level
+               l shares every digit above l with the current time and has a
+               larger digit at l, so all of level l expires before any slot
+               of a higher level starts and the lowest non-empty level
+               always holds the next expiry.
+ ============================================================================
+ */
+
+#include <stdlib.h>
+#include "timerwheel.h"
+
+#define LEVEL_SPAN(l) ((simTime)1 << (TW_BITS * (l)))	/* Ticks covered by one slot of level l */
+
+int twInit(timerWheel *w, int numOfProcesses) {
+	size_t n = numOfProcesses > 0 ? numOfProcesses : 1;
+	int l, s;
+
+	w->next = malloc(n * (sizeof(int) + sizeof(simTime)));	/*One allocation for both arrays*/
+	if(w->next == NULL) {
+		return -1;
+	}
+	w->expiry = (simTime *)w->next;
+	w->next = (int *)(w->expiry + n);
+	for(l=0; l<TW_LEVELS; l++) {
+		for(s=0; s<TW_SLOTS; s++) {
+			w->head[l][s] = -1;
+		}
+		w->occupied[l] = 0;
+	}
+	w->now = 0;
+	w->expiredHead = w->expiredTail = -1;
+	w->count = 0;
+	return 0;
+}
+
+void twFree(timerWheel *w) {
+	free(w->expiry);
+	w->expiry = NULL;
+	w->next = NULL;
+}
+
+/* Puts an entry into the slot its expiry falls in as seen from the current time, behind those already there */
+static void place(timerWheel *w, int index, simTime when) {
+	unsigned long long diff = (unsigned long long)(when ^ w->now);
+	int level = diff < TW_SLOTS ? 0 : (63 - __builtin_clzll(diff)) / TW_BITS;
+	int slot = (int)(when >> (TW_BITS * level)) & (TW_SLOTS - 1);
+
+	w->next[index] = -1;
+	if(w->head[level][slot] == -1) {
+		w->head[level][slot] = index;
+		w->minExpiry[level][slot] = when;
+		w->occupied[level] |= 1ULL << slot;
+	} else {
+		w->next[w->tail[level][slot]] = index;
+		if(when < w->minExpiry[level][slot]) {
+			w->minExpiry[level][slot] = when;
+		}
+	}
+	w->tail[level][slot] = index;
+}
+
+/* Empties a slot, returning the list it held */
+static int takeSlot(timerWheel *w, int level, int slot) {
+	int first = w->head[level][slot];
+
+	w->head[level][slot] = -1;
+	w->occupied[level] &= ~(1ULL << slot);
+	return first;
+}
+
+/**
+ * Function Name: 	twAdd
+ * Function:		Puts a process on the wheel till given time
+ * Input:			Wheel, process, expiry (not before the time the wheel was advanced to)
+ * Output:			None
+ * Affects:			Wheel
+ */
+
+void twAdd(timerWheel *w, int index, simTime when) {
+	w->expiry[index] = when;
+	place(w, index, when);
+	w->count++;
+}
+
+/**
+ * Function Name: 	twAdvance
+ * Function:		Moves the wheel forward to given time. Entries due by then are appended to the expired list in
+ * 					expiry order, those of one tick in the order they were added
+ * Input:			Wheel, time (not before the time it was advanced to)
+ * Output:			None
+ * Affects:			Wheel
+ * NOTES:			Only slots holding entries are visited. A slot of level 0 holds one tick and is moved to the
+ * 					expired list as it is; a slot of a higher level is redistributed to lower levels once the clock
+ * 					reaches its start. Each entry is redistributed at most once per level.
+ */
+
+void twAdvance(timerWheel *w, simTime target) {
+	simTime start;
+	int level, slot, index, next;
+
+	for(;;) {
+		if(w->occupied[0]) {
+			slot = __builtin_ctzll(w->occupied[0]);
+			start = (w->now & ~(simTime)(TW_SLOTS - 1)) | slot;
+			if(start > target) {
+				break;
+			}
+			index = takeSlot(w, 0, slot);
+			if(w->expiredHead == -1) {
+				w->expiredHead = index;
+			} else {
+				w->next[w->expiredTail] = index;
+			}
+			w->expiredTail = w->tail[0][slot];
+			w->now = start;
+			continue;
+		}
+
+		for(level=1; level<TW_LEVELS && w->occupied[level] == 0; level++);
+		if(level == TW_LEVELS) {
+			break;
+		}
+		slot = __builtin_ctzll(w->occupied[level]);
+		start = (w->now & ~(LEVEL_SPAN(level + 1) - 1)) | ((simTime)slot << (TW_BITS * level));
+		if(start > target) {
+			break;
+		}
+		w->now = start;
+		for(index=takeSlot(w, level, slot); index != -1; index=next) {
+			next = w->next[index];
+			place(w, index, w->expiry[index]);
+		}
+	}
+	if(target > w->now) {
+		w->now = target;		/*Whatever is left starts after target, so it stays where it is*/
+	}
+}
+
+int twFirst(const timerWheel *w) {
+	return w->expiredHead;
+}
+
+int twPop(timerWheel *w) {
+	int index = w->expiredHead;
+
+	if(index != -1) {
+		w->expiredHead = index == w->expiredTail ? -1 : w->next[index];
+		w->count--;
+	}
+	return index;
+}
+
+/**
+ * Function Name: 	twNext
+ * Function:		Earliest expiry among entries not yet moved to the expired list
+ * Input:			Wheel
+ * Output:			Expiry, -1 if there is none
+ * Affects:			Nothing
+ * NOTES:			Lowest non-empty level holds the earliest entry, its first slot keeps its earliest expiry.
+ */
+
+simTime twNext(const timerWheel *w) {
+	int level;
+
+	if(w->occupied[0]) {
+		return (w->now & ~(simTime)(TW_SLOTS - 1)) | __builtin_ctzll(w->occupied[0]);
+	}
+	for(level=1; level<TW_LEVELS; level++) {
+		if(w->occupied[level]) {
+			return w->minExpiry[level][__builtin_ctzll(w->occupied[level])];
+		}
+	}
+	return -1;
+}
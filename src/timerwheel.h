@@ -0,0 +1,51 @@
+/*
+ ============================================================================
+ Name        : timerwheel.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Hierarchical timer wheel of process indices, used by the
+               engine to hold processes blocked on I/O till they wake up.
+               Level l has 64 slots, each covering 64^l ticks; an entry
+               sits at the level of the highest 6 bit digit in which its
+               expiry differs from the current time. Adding is O(1), and
+               an entry is moved down at most once per level before it
+               expires, so waking is O(1) amortized no matter how many
+               processes are blocked. A bitmap per level finds the next
+               occupied slot without scanning empty ones.
+               Entries expiring at the same tick come out in the order
+               they were added.
+ ============================================================================
+ */
+
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+#include <stdint.h>
+#include "proctable.h"
+
+#define TW_BITS 6
+#define TW_SLOTS (1 << TW_BITS)
+#define TW_LEVELS ((63 + TW_BITS - 1) / TW_BITS)	/* Enough levels for any non-negative simTime */
+
+typedef struct {
+	int *next;					/* Next entry in slot or expired list, per process */
+	simTime *expiry;			/* Expiry of every process on the wheel */
+	int head[TW_LEVELS][TW_SLOTS];	/* First and last entry of every slot, -1 if empty */
+	int tail[TW_LEVELS][TW_SLOTS];
+	simTime minExpiry[TW_LEVELS][TW_SLOTS];	/* Earliest expiry in every slot */
+	uint64_t occupied[TW_LEVELS];	/* Bit per non-empty slot */
+	simTime now;				/* Wheel has been advanced up to here */
+	int expiredHead;			/* Entries due by now, in expiry order */
+	int expiredTail;
+	int count;					/* Entries on the wheel or expired, not yet popped */
+}timerWheel;
+
+int twInit(timerWheel *, int);				/* Wheel for given number of processes at time 0, returns 0 on success */
+void twFree(timerWheel *);
+void twAdd(timerWheel *, int, simTime);		/* Process, expiry (not before the time wheel was advanced to) */
+void twAdvance(timerWheel *, simTime);		/* Moves every entry expiring by given time to the expired list */
+int twFirst(const timerWheel *);			/* First expired process, -1 if none */
+int twPop(timerWheel *);					/* Removes and returns first expired process, -1 if none */
+simTime twNext(const timerWheel *);			/* Earliest expiry of an entry not expired yet, -1 if none */
+
+#endif /* TIMERWHEEL_H_ */
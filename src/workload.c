@@ -0,0 +1,643 @@
+/*
+ ============================================================================
+ Name        : workload.c
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Trace loader, see workload.h for the formats. Text traces are
+               read with one read into a buffer and split in place, names
+               are interned into the string table of the process table.
+               Binary traces are mapped and used without parsing, their
+               string table is used as it is.
+ ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "workload.h"
+#include "profile.h"
+
+#define MAX_FIELDS 4
+
+/* Reads whole stream into a NUL terminated buffer. Size hint avoids regrowing for regular files */
+static char *readAll(int fd, size_t hint, size_t *length) {
+	size_t size = hint + 1 > 4096 ? hint + 1 : 4096, used = 0;
+	char *buf = malloc(size), *grown;
+	ssize_t got;
+
+	while(buf) {
+		if(used + 1 == size) {
+			grown = realloc(buf, size * 2);
+			if(grown == NULL) {
+				break;
+			}
+			buf = grown;
+			size *= 2;
+		}
+		got = read(fd, buf + used, size - used - 1);
+		if(got < 0) {
+			break;
+		}
+		if(got == 0) {
+			buf[used] = '\0';
+			*length = used;
+			return buf;
+		}
+		used += got;
+	}
+	free(buf);
+	return NULL;
+}
+
+/* Sets up arena for the run and allocates process table from it */
+static int newTable(procTable *t, arena *runArena, size_t maxProcesses, size_t extraBytes) {
+	if(arenaInit(runArena, maxProcesses * PROC_TABLE_BYTES + extraBytes) != 0) {
+		return -1;
+	}
+	return procTableInit(t, runArena, (int)maxProcesses);
+}
+
+static int parseNumber(const char *field, simTime *value) {
+	char *end;
+
+	*value = strtoll(field, &end, 10);
+	return end != field && *end == '\0';
+}
+
+/* Times cannot be negative, priorities can (CFS takes nice = -priority) */
+static int parseTime(const char *field, simTime *value) {
+	return parseNumber(field, value) && *value >= 0;
+}
+
+/**
+ * Function Name: 	parseLine
+ * Function:		Splits one line of a text trace in place into name, arrival, burst and optional priority
+ * Input:			Line, its number, flag telling no record was seen yet (cleared here), fields to fill. The
+ * 					bursts following the first one are left unparsed, see parseBursts()
+ * Output:			1 for a record, 0 for a line to skip (blank, comment, count or header), -1 if malformed
+ * Affects:			Line (separators replaced by NUL), flag, fields
+ */
+
+static int parseLine(char *line, int lineNo, int *firstRecord, char **name, simTime *arrival, simTime *burst,
+		char **moreBursts, simTime *priority, int *hasPriority) {
+	char *p, *field[MAX_FIELDS];
+	int numFields = 0;
+	simTime value;
+
+	/*Split into fields on commas and blanks*/
+	p = line;
+	while(*p && *p != '#') {
+		while(*p == ' ' || *p == '\t' || *p == ',' || *p == '\r' || *p == '\n') {
+			*p++ = '\0';
+		}
+		if(*p == '\0' || *p == '#') {
+			break;
+		}
+		if(numFields == MAX_FIELDS) {
+			fprintf(stderr, "Line %d: too many fields\n", lineNo);
+			return -1;
+		}
+		field[numFields++] = p;
+		while(*p && *p != ' ' && *p != '\t' && *p != ',' && *p != '\r' && *p != '\n' && *p != '#') {
+			p++;
+		}
+	}
+	if(*p == '#') {
+		*p = '\0';
+	}
+	if(numFields == 0) {
+		return 0;
+	}
+
+	/*First line may be old style process count or a CSV header*/
+	if(*firstRecord) {
+		*firstRecord = 0;
+		if(numFields == 1 && parseTime(field[0], &value)) {
+			return 0;
+		}
+		if(numFields >= 2 && !parseTime(field[1], &value)) {
+			return 0;
+		}
+	}
+
+	*moreBursts = numFields >= 3 ? strchr(field[2], '/') : NULL;
+	if(*moreBursts) {
+		*(*moreBursts)++ = '\0';
+	}
+	if(numFields < 3 || !parseTime(field[1], arrival) || !parseTime(field[2], burst)) {
+		fprintf(stderr, "Line %d: expected \"name arrival burst [priority]\"\n", lineNo);
+		return -1;
+	}
+	*priority = 0;
+	if(numFields == 4) {
+		if(!parseNumber(field[3], priority) || *priority > INT_MAX || *priority < INT_MIN) {
+			fprintf(stderr, "Line %d: bad priority\n", lineNo);
+			return -1;
+		}
+		*hasPriority = 1;
+	}
+	*name = field[0];
+	return 1;
+}
+
+/* Parses the I/O, CPU pairs following the first CPU burst of a line into bursts, returns how many there are or -1 */
+static long parseBursts(char *text, int lineNo, simTime *bursts) {
+	char *next;
+	long count = 0;
+
+	for(; text; text=next) {
+		next = strchr(text, '/');
+		if(next) {
+			*next++ = '\0';
+		}
+		if(!parseTime(text, &bursts[count++])) {
+			fprintf(stderr, "Line %d: bad burst\n", lineNo);
+			return -1;
+		}
+	}
+	if(count % 2 != 0) {
+		fprintf(stderr, "Line %d: bursts must alternate cpu/io/.../cpu\n", lineNo);
+		return -1;
+	}
+	return count;
+}
+
+/**
+ * Function Name: 	parseText
+ * Function:		Splits text trace in place. Each line becomes one process, names are interned. I/O columns are
+ * 					only kept when some process has I/O bursts
+ * Input:			NUL terminated text, arena of the run, extra arena bytes wanted per process, workload
+ * Output:			0 on success, -1 on malformed input or out of memory
+ * Affects:			Text (separators replaced by NUL), arena, workload
+ */
+
+static int parseText(char *text, arena *runArena, size_t extraPerProcess, workload *wl) {
+	procTable *t = &wl->table;
+	stringTable names;
+	char *line, *next, *p, *field, *moreBursts;
+	size_t maxProcesses = 1, maxBursts = 0, numBursts = 0;
+	int lineNo = 0, firstRecord = 1, n = 0, ret;
+	simTime priority, *bursts = NULL;
+	long name, count;
+
+	for(p=text; *p; p++) {
+		maxProcesses += *p == '\n';
+		maxBursts += *p == '/';
+	}
+	if(maxProcesses > INT_MAX || maxBursts > UINT_MAX ||
+			newTable(t, runArena, maxProcesses, maxProcesses * extraPerProcess + maxBursts * sizeof(simTime) + 4096) != 0 ||
+			stringTableInit(&names, runArena, 1024) != 0 || (maxBursts > 0 &&
+			((bursts = arenaAlloc(runArena, maxBursts * sizeof(simTime))) == NULL || procTableInitIo(t, runArena) != 0))) {
+		fprintf(stderr, "Not enough memory for %zu processes\n", maxProcesses);
+		return -1;
+	}
+
+	for(line=text; line; line=next) {
+		lineNo++;
+		next = strchr(line, '\n');
+		if(next) {
+			*next++ = '\0';
+		}
+		ret = parseLine(line, lineNo, &firstRecord, &field, &t->arrivalTime[n], &t->burstTime[n], &moreBursts, &priority,
+				&wl->hasPriority);
+		if(ret < 0) {
+			return -1;
+		}
+		if(ret == 0) {
+			continue;
+		}
+		if(moreBursts) {
+			if((count = parseBursts(moreBursts, lineNo, bursts + numBursts)) < 0) {
+				return -1;
+			}
+			t->ioLeft[n] = (int)(count / 2);
+			t->nextBurst[n] = (unsigned)numBursts;
+			numBursts += count;
+		}
+		if((name = intern(&names, field)) < 0) {
+			fprintf(stderr, "Not enough memory for process names\n");
+			return -1;
+		}
+		t->name[n] = (unsigned)name;
+		t->priority[n] = (int)priority;
+		n++;
+	}
+	t->numOfProcesses = n;
+	t->strings = names.buf;
+	t->stringsSize = names.used;
+	if(numBursts == 0) {
+		t->ioLeft = NULL;		/*Only comments had a '/'*/
+		t->nextBurst = NULL;
+		t->ioTime = NULL;
+	}
+	t->bursts = bursts;
+	t->numBursts = numBursts;
+	return 0;
+}
+
+/* Offset of I/O section of a binary trace, following its string table */
+static uint64_t ioOffset(const traceHeader *hdr) {
+	return (hdr->namesOffset + hdr->namesSize + 7) & ~(uint64_t)7;
+}
+
+/**
+ * Function Name: 	parseIo
+ * Function:		Checks I/O section of a binary trace and points the I/O columns of the table at its bursts
+ * Input:			Start of trace in memory, its size, arena of the run, workload whose records are loaded
+ * Output:			0 on success, -1 on malformed trace or out of memory
+ * Affects:			Arena, workload
+ */
+
+static int parseIo(const char *base, size_t size, arena *runArena, workload *wl) {
+	const traceHeader *hdr = (const traceHeader *)base;
+	procTable *t = &wl->table;
+	uint64_t at = ioOffset(hdr), numBursts, i, next = 0;
+	const uint32_t *ioCount;
+	const simTime *bursts;
+
+	if(at > size || size - at < sizeof(uint64_t)) {
+		fprintf(stderr, "Corrupt binary trace I/O section\n");
+		return -1;
+	}
+	numBursts = *(const uint64_t *)(base + at);
+	bursts = (const simTime *)(base + at + sizeof(uint64_t));
+	ioCount = (const uint32_t *)(bursts + numBursts);
+	if(numBursts > UINT_MAX || numBursts > (size - at - sizeof(uint64_t)) / sizeof(simTime) ||
+			hdr->count > (size - at - sizeof(uint64_t) - numBursts * sizeof(simTime)) / sizeof(uint32_t)) {
+		fprintf(stderr, "Corrupt binary trace I/O section\n");
+		return -1;
+	}
+	if(procTableInitIo(t, runArena) != 0) {
+		fprintf(stderr, "Not enough memory for I/O bursts\n");
+		return -1;
+	}
+	for(i=0; i<hdr->count; i++) {
+		if(ioCount[i] > INT_MAX || ioCount[i] > (numBursts - next) / 2) {
+			fprintf(stderr, "Corrupt binary trace I/O section\n");
+			return -1;
+		}
+		t->ioLeft[i] = (int)ioCount[i];
+		t->nextBurst[i] = (unsigned)next;
+		next += 2 * (uint64_t)ioCount[i];
+	}
+	for(i=0; i<numBursts; i++) {
+		if(bursts[i] < 0) {
+			fprintf(stderr, "Corrupt binary trace burst %llu\n", (unsigned long long)i);
+			return -1;
+		}
+	}
+	t->bursts = bursts;
+	t->numBursts = numBursts;
+	return 0;
+}
+
+/**
+ * Function Name: 	parseBinary
+ * Function:		Checks binary trace and fills process table straight from its records
+ * Input:			Start of trace in memory, its size, arena of the run, extra arena bytes wanted per process and in
+ * 					all, workload
+ * Output:			0 on success, -1 on malformed trace or out of memory
+ * Affects:			Arena, workload
+ */
+
+static int parseBinary(const char *base, size_t size, arena *runArena, size_t extraPerProcess, size_t extraBytes,
+		workload *wl) {
+	const traceHeader *hdr = (const traceHeader *)base;
+	const traceRecord *rec = (const traceRecord *)(hdr + 1);
+	procTable *t = &wl->table;
+	int io = memcmp(hdr->magic, TRACE_MAGIC_IO, sizeof(hdr->magic)) == 0;
+	uint64_t i;
+
+	if(size < sizeof(traceHeader) || hdr->count > INT_MAX ||
+			hdr->count > (size - sizeof(traceHeader)) / sizeof(traceRecord) ||
+			hdr->namesOffset > size || hdr->namesSize > size - hdr->namesOffset ||
+			(hdr->count > 0 && (hdr->namesSize == 0 || base[hdr->namesOffset + hdr->namesSize - 1] != '\0'))) {
+		fprintf(stderr, "Corrupt binary trace\n");
+		return -1;
+	}
+	if(newTable(t, runArena, hdr->count, hdr->count * (extraPerProcess + (io ? PROC_IO_BYTES : 0)) + extraBytes) != 0) {
+		fprintf(stderr, "Not enough memory for %llu processes\n", (unsigned long long)hdr->count);
+		return -1;
+	}
+	for(i=0; i<hdr->count; i++) {
+		if(rec[i].name >= hdr->namesSize || rec[i].arrivalTime < 0 || rec[i].burstTime < 0) {
+			fprintf(stderr, "Corrupt binary trace record %llu\n", (unsigned long long)i);
+			return -1;
+		}
+		t->name[i] = rec[i].name;
+		t->arrivalTime[i] = rec[i].arrivalTime;
+		t->burstTime[i] = rec[i].burstTime;
+		t->priority[i] = rec[i].priority;
+	}
+	t->strings = base + hdr->namesOffset;
+	t->stringsSize = hdr->namesSize;
+	wl->hasPriority = 1;
+	return io ? parseIo(base, size, runArena, wl) : 0;
+}
+
+/* Tells whether a magic is one of a binary trace */
+static int isBinary(const char *magic) {
+	return strncmp(magic, TRACE_MAGIC, sizeof(((traceHeader *)0)->magic)) == 0 ||
+			strncmp(magic, TRACE_MAGIC_IO, sizeof(((traceHeader *)0)->magic)) == 0;
+}
+
+/* Body of loadWorkload() */
+static int loadTrace(const char *path, arena *runArena, size_t extraPerProcess, workload *wl) {
+	struct stat st;
+	char magic[sizeof(((traceHeader *)0)->magic)];
+	const traceHeader *hdr;
+	char *text;
+	size_t length, tail;
+	void *copy;
+	int fd, ret;
+
+	memset(wl, 0, sizeof(*wl));
+	runArena->current = NULL;
+	fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+	if(fd < 0 || fstat(fd, &st) != 0) {
+		perror(path);
+		return -1;
+	}
+
+	/*Regular binary trace files are mapped, nothing is read or copied*/
+	if(S_ISREG(st.st_mode) && (size_t)st.st_size >= sizeof(traceHeader) &&
+			pread(fd, magic, sizeof(magic), 0) == sizeof(magic) && isBinary(magic)) {
+		wl->mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(fd != STDIN_FILENO) close(fd);
+		if(wl->mapping == MAP_FAILED) {
+			wl->mapping = NULL;
+			perror(path);
+			return -1;
+		}
+		wl->mappingSize = st.st_size;
+		madvise(wl->mapping, wl->mappingSize, MADV_SEQUENTIAL);
+		return parseBinary(wl->mapping, wl->mappingSize, runArena, extraPerProcess, 0, wl);
+	}
+
+	text = readAll(fd, S_ISREG(st.st_mode) ? st.st_size : 0, &length);
+	if(fd != STDIN_FILENO) close(fd);
+	if(text == NULL) {
+		perror(path);
+		return -1;
+	}
+	if(length >= sizeof(traceHeader) && isBinary(text)) {
+		/*Binary trace piped through stdin, string table and bursts are copied out of the buffer*/
+		hdr = (const traceHeader *)text;
+		tail = hdr->namesOffset < length ? length - hdr->namesOffset : 0;	/*Names and I/O section*/
+		ret = parseBinary(text, length, runArena, extraPerProcess, tail + 32, wl);	/*Both copies, rounded up*/
+		if(ret == 0) {
+			if((copy = arenaAlloc(runArena, wl->table.stringsSize + 1)) == NULL) {
+				fprintf(stderr, "Not enough memory for process names\n");
+				ret = -1;
+			} else {
+				wl->table.strings = memcpy(copy, wl->table.strings, wl->table.stringsSize);
+			}
+		}
+		if(ret == 0 && wl->table.ioLeft) {
+			if((copy = arenaAlloc(runArena, wl->table.numBursts * sizeof(simTime) + 1)) == NULL) {
+				fprintf(stderr, "Not enough memory for I/O bursts\n");
+				ret = -1;
+			} else {
+				wl->table.bursts = memcpy(copy, wl->table.bursts, wl->table.numBursts * sizeof(simTime));
+			}
+		}
+	} else {
+		ret = parseText(text, runArena, extraPerProcess, wl);
+	}
+	free(text);
+	return ret;
+}
+
+/**
+ * Function Name: 	loadWorkload
+ * Function:		Loads a text or binary trace (detected from its first bytes). Arena of the run is created
+ * 					here since only the loader knows how many processes there are
+ * Input:			Path of trace ("-" for stdin), arena of the run, extra arena bytes wanted per process, workload
+ * Output:			0 on success, -1 on error (message already printed)
+ * Affects:			Arena, workload
+ */
+
+int loadWorkload(const char *path, arena *runArena, size_t extraPerProcess, workload *wl) {
+	int ret;
+
+	PROF_BEGIN(PROF_LOAD);
+	ret = loadTrace(path, runArena, extraPerProcess, wl);
+	PROF_END(PROF_LOAD);
+	return ret;
+}
+
+/* Writes count items, 1 if all of them were written */
+static int writeItems(FILE *fp, const void *items, size_t size, size_t count) {
+	return fwrite(items, size, count, fp) == count;
+}
+
+/**
+ * Function Name: 	saveBinaryWorkload
+ * Function:		Writes processes of a workload as binary trace so it can be replayed without parsing. Workloads
+ * 					with I/O bursts get an I/O section (TRACE_MAGIC_IO)
+ * Input:			Path, workload
+ * Output:			0 on success, -1 on error (message already printed)
+ * Affects:			Nothing
+ */
+
+int saveBinaryWorkload(const char *path, const workload *wl) {
+	const procTable *t = &wl->table;
+	static const char pad[8];
+	traceHeader hdr;
+	traceRecord rec;
+	uint64_t numBursts = 0;
+	uint32_t ioCount;
+	FILE *fp;
+	int i, ok;
+
+	if(t->stringsSize > UINT32_MAX) {
+		fprintf(stderr, "%s: names do not fit in binary trace\n", path);
+		return -1;
+	}
+	fp = fopen(path, "wb");
+	if(fp == NULL) {
+		perror(path);
+		return -1;
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, t->ioLeft ? TRACE_MAGIC_IO : TRACE_MAGIC, sizeof(hdr.magic));
+	hdr.count = t->numOfProcesses;
+	hdr.namesOffset = sizeof(hdr) + hdr.count * sizeof(traceRecord);
+	hdr.namesSize = t->stringsSize;
+	ok = writeItems(fp, &hdr, sizeof(hdr), 1);
+
+	memset(&rec, 0, sizeof(rec));
+	for(i=0; i<t->numOfProcesses; i++) {
+		rec.arrivalTime = t->arrivalTime[i];
+		rec.burstTime = t->burstTime[i];
+		rec.priority = t->priority[i];
+		rec.name = t->name[i];
+		ok = ok && writeItems(fp, &rec, sizeof(rec), 1);
+	}
+	ok = ok && writeItems(fp, t->strings, 1, t->stringsSize);	/*Names are already interned, table is written as it is*/
+
+	if(t->ioLeft) {
+		ok = ok && writeItems(fp, pad, 1, ioOffset(&hdr) - (hdr.namesOffset + hdr.namesSize));
+		for(i=0; i<t->numOfProcesses; i++) {
+			numBursts += 2 * (uint64_t)t->ioLeft[i];
+		}
+		ok = ok && writeItems(fp, &numBursts, sizeof(numBursts), 1);
+		for(i=0; i<t->numOfProcesses; i++) {
+			ok = ok && writeItems(fp, t->bursts + t->nextBurst[i], sizeof(simTime), 2 * (size_t)t->ioLeft[i]);
+		}
+		for(i=0; i<t->numOfProcesses; i++) {
+			ioCount = t->ioLeft[i];
+			ok = ok && writeItems(fp, &ioCount, sizeof(ioCount), 1);
+		}
+	}
+
+	/*A full disk or closed pipe may only show when buffered data is flushed*/
+	if(!ok) {
+		perror(path);
+		fclose(fp);
+		return -1;
+	}
+	if(fclose(fp) != 0) {
+		perror(path);
+		return -1;
+	}
+	return 0;
+}
+
+void freeWorkload(workload *wl) {
+	if(wl->mapping) {
+		munmap(wl->mapping, wl->mappingSize);
+	}
+	wl->mapping = NULL;
+	memset(&wl->table, 0, sizeof(wl->table));
+}
+
+/**
+ * Function Name: 	traceOpen
+ * Function:		Opens a trace to be read one process at a time by traceNext(). Text traces are read line by
+ * 					line, so they may come from a pipe. Binary traces must be regular files since their names
+ * 					follow all records; they are mapped so pages already read can be reclaimed.
+ * Input:			Path of trace ("-" for stdin), reader
+ * Output:			0 on success, -1 on error (message already printed)
+ * Affects:			Reader
+ */
+
+int traceOpen(const char *path, traceReader *r) {
+	struct stat st;
+	char magic[sizeof(((traceHeader *)0)->magic)];
+	const traceHeader *hdr;
+	int fd;
+
+	memset(r, 0, sizeof(*r));
+	r->firstRecord = 1;
+	r->file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+	if(r->file == NULL || fstat(fileno(r->file), &st) != 0) {
+		perror(path);
+		return -1;
+	}
+	fd = fileno(r->file);
+	if(!S_ISREG(st.st_mode) || (size_t)st.st_size < sizeof(traceHeader) ||
+			pread(fd, magic, sizeof(magic), 0) != sizeof(magic) || !isBinary(magic)) {
+		return 0;
+	}
+	if(memcmp(magic, TRACE_MAGIC_IO, sizeof(magic)) == 0) {
+		fprintf(stderr, "%s: I/O bursts cannot be streamed\n", path);
+		traceClose(r);
+		return -1;
+	}
+
+	r->mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(r->file != stdin) fclose(r->file);
+	r->file = NULL;
+	if(r->mapping == MAP_FAILED) {
+		r->mapping = NULL;
+		perror(path);
+		return -1;
+	}
+	r->mappingSize = st.st_size;
+	madvise(r->mapping, r->mappingSize, MADV_SEQUENTIAL);
+	hdr = r->mapping;
+	if(hdr->count > (r->mappingSize - sizeof(traceHeader)) / sizeof(traceRecord) ||
+			hdr->namesOffset > r->mappingSize || hdr->namesSize > r->mappingSize - hdr->namesOffset ||
+			(hdr->count > 0 && (hdr->namesSize == 0 || ((const char *)r->mapping)[hdr->namesOffset + hdr->namesSize - 1] != '\0'))) {
+		fprintf(stderr, "Corrupt binary trace\n");
+		traceClose(r);
+		return -1;
+	}
+	r->hasPriority = 1;
+	return 0;
+}
+
+/**
+ * Function Name: 	traceNext
+ * Function:		Reads next process of a trace opened by traceOpen(). Names longer than the buffer are cut
+ * Input:			Reader, name buffer and its size, arrival, burst and priority to fill
+ * Output:			1 when a process was read, 0 at end of trace, -1 on malformed trace (message already printed)
+ * Affects:			Reader, name buffer, arrival, burst, priority
+ */
+
+int traceNext(traceReader *r, char *name, size_t nameSize, simTime *arrival, simTime *burst, int *priority) {
+	const traceHeader *hdr = r->mapping;
+	const traceRecord *rec;
+	char *field, *moreBursts;
+	simTime value;
+	int ret;
+
+	if(r->mapping) {
+		if(r->next == hdr->count) {
+			return 0;
+		}
+		rec = (const traceRecord *)(hdr + 1) + r->next++;
+		if(rec->name >= hdr->namesSize || rec->arrivalTime < 0 || rec->burstTime < 0) {
+			fprintf(stderr, "Corrupt binary trace record %llu\n", (unsigned long long)(r->next - 1));
+			return -1;
+		}
+		snprintf(name, nameSize, "%s", (const char *)r->mapping + hdr->namesOffset + rec->name);
+		*arrival = rec->arrivalTime;
+		*burst = rec->burstTime;
+		*priority = rec->priority;
+		return 1;
+	}
+
+	while(getline(&r->line, &r->lineSize, r->file) >= 0) {
+		r->lineNo++;
+		if(r->lineNo == 1 && isBinary(r->line)) {
+			fprintf(stderr, "Binary trace can only be streamed from a file, names follow all records\n");
+			return -1;
+		}
+		ret = parseLine(r->line, r->lineNo, &r->firstRecord, &field, arrival, burst, &moreBursts, &value, &r->hasPriority);
+		if(ret > 0 && moreBursts) {
+			fprintf(stderr, "Line %d: I/O bursts cannot be streamed\n", r->lineNo);
+			return -1;
+		}
+		if(ret != 0) {
+			if(ret > 0) {
+				snprintf(name, nameSize, "%s", field);
+				*priority = (int)value;
+			}
+			return ret;
+		}
+	}
+	if(ferror(r->file)) {
+		perror("trace");
+		return -1;
+	}
+	return 0;
+}
+
+void traceClose(traceReader *r) {
+	if(r->file && r->file != stdin) {
+		fclose(r->file);
+	}
+	if(r->mapping) {
+		munmap(r->mapping, r->mappingSize);
+	}
+	free(r->line);
+	memset(r, 0, sizeof(*r));
+}
@@ -0,0 +1,87 @@
+/*
+ ============================================================================
+ Name        : workload.h
+ Author      : Muneeb Shaikh
+ Copyright   : GPLv3
+ Description : Loads the processes to be scheduled from a trace file or
+               stdin, so that every algorithm runs on the same loaded
+               representation.
+
+               Text trace: one process per line, fields separated by commas
+               or blanks:
+                   name arrival burst [priority]
+               Lines starting with '#' are comments. A first line holding
+               only the number of processes (old batch format) or a CSV
+               header is skipped. A process alternating CPU and I/O gives
+               its bursts separated by '/', CPU first and last:
+                   name arrival cpu/io/cpu/.../cpu [priority]
+
+               Binary trace (little endian, memory-mapped when loaded):
+                   traceHeader
+                   traceRecord[count]
+                   string table of NUL terminated names
+               With TRACE_MAGIC_IO the records hold the first CPU burst and
+               an I/O section follows, at the next multiple of 8 bytes:
+                   uint64_t number of bursts
+                   int64_t bursts: I/O, CPU pairs of every process in
+                           record order
+                   uint32_t I/O bursts of every process
+ ============================================================================
+ */
+
+#ifndef WORKLOAD_H_
+#define WORKLOAD_H_
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "proctable.h"
+#include "arena.h"
+
+#define TRACE_MAGIC "SCHEDTR1"
+#define TRACE_MAGIC_IO "SCHEDTR2"	/* Same, followed by I/O bursts */
+
+typedef struct {
+	char magic[8];				/* TRACE_MAGIC */
+	uint64_t count;				/* Number of records */
+	uint64_t namesOffset;		/* Byte offset of string table from start of file */
+	uint64_t namesSize;			/* Size of string table in bytes */
+}traceHeader;
+
+typedef struct {
+	int64_t arrivalTime;
+	int64_t burstTime;
+	int32_t priority;
+	uint32_t name;				/* Offset of name inside string table */
+}traceRecord;
+
+typedef struct {
+	procTable table;			/* Process table, allocated in the arena of the run */
+	int hasPriority;			/* Trace carried a priority column */
+	void *mapping;				/* Mapped binary trace, string table of process table points into it */
+	size_t mappingSize;
+}workload;
+
+/* Reads a trace one process at a time, for streaming runs that never hold the whole trace */
+typedef struct {
+	FILE *file;					/* Text trace */
+	char *line;					/* Line buffer of getline() */
+	size_t lineSize;
+	int lineNo;
+	int firstRecord;
+	void *mapping;				/* Mapped binary trace, records are taken in order */
+	size_t mappingSize;
+	uint64_t next;				/* Next binary record */
+	int hasPriority;			/* Priority column seen so far */
+}traceReader;
+
+int loadWorkload(const char *, arena *, size_t, workload *);	/* Loads file ("-" for stdin), returns 0 on success */
+int saveBinaryWorkload(const char *, const workload *);		/* Writes binary trace, returns 0 on success */
+void freeWorkload(workload *);									/* Releases mapping of binary trace */
+int traceOpen(const char *, traceReader *);					/* Opens file ("-" for stdin) for traceNext(), returns 0 on success */
+int traceNext(traceReader *, char *, size_t, simTime *, simTime *, int *);	/* Name buffer and its size, arrival, burst, priority.
+																				   1 for a process, 0 at end, -1 on error (I/O
+																				   bursts included, they cannot be streamed) */
+void traceClose(traceReader *);
+
+#endif /* WORKLOAD_H_ */